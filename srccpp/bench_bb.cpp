@@ -0,0 +1,107 @@
+/**@file   bench_bb.cpp
+ * @brief  Benchmark of the combinatorial branch and bound against the MISOCP of CPLEX
+ * @author Liding Xu
+ *
+ * usage: bench_bb record_file [time_limit] [max_problems]
+ * The pricing problems are recorded by cbp with the parameter cbp/pricing_record, run cbp with cbp/bb_max_items = 0 so that the small problems are recorded too.
+ * Each problem is solved by the branch and bound (solve_conic_knap_bb) and by the MISOCP (solve_micp), the problems are grouped by their numbers of items,
+ * the mean and the maximal solving times, the numbers of solves to optimality and of disagreements of the optimal values are printed per group.
+ * The crossover of the mean times is a value for cbp/bb_max_items.
+ *---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <list>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include "conic_knapsack.h"
+#include "conic_knapsack_bb.h"
+#include "conic_knapsack_pwlbc.h"
+
+using namespace std;
+
+int main(int argc, char ** argv){
+	if(argc < 2){
+		cerr << "usage: " << argv[0] << " record_file [time_limit] [max_problems]" << endl;
+		return 1;
+	}
+	ifstream in(argv[1]);
+	SCIP_Real time_limit = argc > 2 ? atof(argv[2]) : 10;
+	int max_problems = argc > 3 ? atoi(argv[3]) : 1000;
+	const int num_groups = 7;
+	const int group_sizes[num_groups] = {10, 20, 30, 40, 60, 80, 1 << 30};
+	const char * solver_names[2] = {"bb", "micp"};
+
+	// times[group][solver], solves to optimality, and disagreements of the optimal values of the branch and bound with the MISOCP
+	vector<vector<SCIP_Real>> sum_times(num_groups, vector<SCIP_Real>(2, 0)), max_times(num_groups, vector<SCIP_Real>(2, 0)), sum_ticks(num_groups, vector<SCIP_Real>(2, 0));
+	vector<vector<int>> num_optimal(num_groups, vector<int>(2, 0));
+	vector<int> num_group_problems(num_groups, 0), num_differ(num_groups, 0), num_bb_faster(num_groups, 0);
+	int num_problems = 0;
+	vector<SCIP_Real> objs, mus, bs;
+	vector<pair<int, int>> diffs;
+	SCIP_Real Dalpha, capacity, target_lb;
+	int numitems;
+	conf algo_conf;
+	algo_conf.is_mip_start = false;
+	algo_conf.exact_abort_ratio = 1;
+	while(num_problems < max_problems && read_pricing(in, objs, mus, bs, Dalpha, capacity, numitems, diffs, target_lb)){
+		conflict_graph conflict(numitems, diffs);
+		int group = 0;
+		while(numitems > group_sizes[group]){
+			group++;
+		}
+		SCIP_Real vals[2] = {-1, -1}, times[2] = {0, 0};
+		for(int solver = 0; solver < 2; solver++){
+			list<list<int>> sol_pool;
+			SCIP_Real sol_val = 0, sol_ub = MAXFLOAT;
+			SOLTYPE_CKNAP sol_type = Unknown;
+			work_budget budget;
+			auto start = chrono::steady_clock::now();
+			if(solver == 0){
+				solve_conic_knap_bb(objs, mus, bs, Dalpha, capacity, numitems, conflict, algo_conf.exact_columns, sol_pool, sol_val, sol_ub, sol_type, budget, time_limit, target_lb);
+			}
+			else{
+				cplex_model model;
+				solve_micp(objs, mus, bs, Dalpha, capacity, numitems, algo_conf, conflict, model, list<vector<int>>(), sol_pool, sol_val, sol_ub, sol_type, budget, time_limit, target_lb);
+			}
+			times[solver] = chrono::duration<SCIP_Real>(chrono::steady_clock::now() - start).count();
+			sum_times[group][solver] += times[solver];
+			sum_ticks[group][solver] += budget.used();
+			max_times[group][solver] = max(max_times[group][solver], times[solver]);
+			if(sol_type == Optimal || sol_type == Infeasible){
+				num_optimal[group][solver]++;
+				vals[solver] = sol_type == Optimal ? sol_val : 0;
+			}
+		}
+		if(vals[0] >= 0 && vals[1] >= 0 && fabs(vals[0] - vals[1]) > 1e-6 * max(1.0, fabs(vals[1]))){
+			num_differ[group]++;
+		}
+		if(vals[0] >= 0 && times[0] < times[1]){
+			num_bb_faster[group]++;
+		}
+		num_group_problems[group]++;
+		num_problems++;
+	}
+	printf("%d pricing problems, time limit %.1f s\n", num_problems, time_limit);
+	printf("%10s %10s %8s %12s %12s %12s %10s %10s %10s\n", "items", "problems", "solver", "mean time", "max time", "mean ticks", "optimal", "differ", "bb faster");
+	for(int group = 0; group < num_groups; group++){
+		if(num_group_problems[group] == 0){
+			continue;
+		}
+		char range[32];
+		if(group + 1 < num_groups){
+			snprintf(range, sizeof(range), "<= %d", group_sizes[group]);
+		}
+		else{
+			snprintf(range, sizeof(range), "> %d", group_sizes[group - 1]);
+		}
+		for(int solver = 0; solver < 2; solver++){
+			printf("%10s %10d %8s %12.4f %12.4f %12.2f %10d %10d %10d\n", range, num_group_problems[group], solver_names[solver],
+				sum_times[group][solver] / num_group_problems[group], max_times[group][solver],
+				sum_ticks[group][solver] / num_group_problems[group], num_optimal[group][solver], num_differ[group], num_bb_faster[group]);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,182 @@
+/**@file   bench_heur.cpp
+ * @brief  Benchmark of the best fit heuristic pricing against the plain rescan best fit
+ * @author Liding Xu
+ *
+ * usage: bench_heur cbp_file [num_problems] [num_threads]
+ * The pricing problems of 200, 1000 and 5000 items are drawn from the items of the cbp instance, with random duals and n/10 random conflict pairs.
+ * Each problem is solved by the best fit heuristic (solve_conic_knap_best_fit) and by the best fit of the original code rescanning all items
+ * at every greedy step, the mean times per call and the numbers of problems where the best packings differ are printed.
+ *---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <list>
+#include <random>
+#include <chrono>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include "conic_knapsack_heur.h"
+
+using namespace std;
+
+
+/** the best fit heuristic of the original code, every greedy step rescans all items, and the dominated items are found by a pairwise scan */
+static void best_fit_rescan(
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems, /** number of items */
+	const conflict_graph & conflict, /** the conflict graph*/
+    vector<int> & items_bin, /* items in the maximal bin, sorted */
+	SCIP_Real & sol_val /** solution value */
+){
+	vector<short> status(numitems); // -1 unknown, 0 inpacked, 1 packed
+	SCIP_Real best_sol_val  = -1;
+	vector<bool> never_try(numitems, false);
+	for(int item1 = 0; item1 < numitems; item1++){
+		for(int item2 = item1 + 1; item2 < numitems; item2++){
+			if(mus[item1] >= mus[item2] && bs[item1] >= bs[item2] && objs[item1] <= objs[item2]){
+				never_try[item1] = true;
+				break;
+			}
+		}
+	}
+	for(int fix = 0; fix < numitems; fix++){
+		if(objs[fix] < tol || never_try[fix]){
+			continue;
+		}
+		fill(status.begin(), status.end(), -1);
+		SCIP_Real sumb = bs[fix], summu = mus[fix], obj = objs[fix];
+		status[fix] = 1;
+		SCIP_Real lhs = summu +  Dalpha * sqrt(sumb);
+		if(lhs > capacity){
+			continue;
+		}
+		for(int item: conflict.get_diffs(fix)){
+			status[item] = 0;
+		}
+		while(true){
+			SCIP_Real best_ratio  = -1;
+			int candidate = -1;
+			for(int item = 0; item < numitems; item++){
+				if(status[item] != -1){
+					continue;
+				}
+				SCIP_Real lhs_ = summu + mus[item] + Dalpha * sqrt(sumb + bs[item]);
+				if(lhs_ > capacity){
+					status[item] = 0;
+					continue;
+				}
+				SCIP_Real ratio =  objs[item] / (lhs_ - lhs);
+				if(ratio > best_ratio){
+					best_ratio = ratio;
+					candidate = item;
+				}
+			}
+			if(candidate == -1){
+				break;
+			}
+			summu += mus[candidate];
+			sumb += bs[candidate];
+			obj += objs[candidate];
+			lhs = summu + Dalpha * sqrt(sumb);
+			for(int item_: conflict.get_diffs(candidate)){
+				status[item_] = 0;
+			}
+			status[candidate] = 1;
+		}
+		if(obj > best_sol_val){
+			best_sol_val = obj;
+			items_bin.clear();
+			for(int item = 0; item < numitems; item++){
+				if(status[item] == 1){
+					items_bin.push_back(item);
+				}
+			}
+		}
+	}
+	sol_val = best_sol_val;
+}
+
+
+int main(int argc, char ** argv){
+	if(argc < 2){
+		cerr << "usage: " << argv[0] << " cbp_file [num_problems] [num_threads]" << endl;
+		return 1;
+	}
+	int num_problems = argc > 2 ? atoi(argv[2]) : 10;
+	int num_threads = argc > 3 ? atoi(argv[3]) : 1;
+
+	// the items of the instance, in the format of the cbp reader
+	ifstream in(argv[1]);
+	string s;
+	SCIP_Real capacity, alpha, Dalpha;
+	int num_instance_items;
+	in >> s >> capacity >> num_instance_items >> alpha >> Dalpha;
+	vector<SCIP_Real> instance_mus(num_instance_items), instance_bs(num_instance_items);
+	for(SCIP_Real & mu: instance_mus){
+		in >> mu;
+	}
+	for(SCIP_Real & b: instance_bs){
+		in >> b;
+	}
+	if(!in || num_instance_items <= 0){
+		cerr << "cannot read " << argv[1] << endl;
+		return 1;
+	}
+
+	mt19937 rng(1);
+	printf("%s, %d problems per size, %d threads\n", argv[1], num_problems, num_threads);
+	printf("%8s %16s %16s %10s\n", "items", "best fit (ms)", "rescan (ms)", "differ");
+	for(int numitems: {200, 1000, 5000}){
+		SCIP_Real sum_ms = 0, sum_ms_rescan = 0;
+		int num_differ = 0;
+		for(int problem = 0; problem < num_problems; problem++){
+			// random duals around the value of the items in a packing, scaled so that the greedy packing has value about 1
+			vector<SCIP_Real> mus(numitems), bs(numitems), objs(numitems);
+			for(int item = 0; item < numitems; item++){
+				int item_ = rng() % num_instance_items;
+				mus[item] = instance_mus[item_];
+				bs[item] = instance_bs[item_];
+				objs[item] = uniform_real_distribution<SCIP_Real>(0.6, 1.3)(rng) * (mus[item] + Dalpha * Dalpha * bs[item] / capacity) / capacity;
+			}
+			SCIP_Real scale = 0;
+			for(SCIP_Real obj: objs){
+				scale += obj;
+			}
+			for(SCIP_Real & obj: objs){
+				obj *= numitems * uniform_real_distribution<SCIP_Real>(0.05, 0.15)(rng) / scale;
+			}
+			vector<pair<int, int>> diffs;
+			for(int pair_ = 0; pair_ < numitems / 10; pair_++){
+				int item1 = rng() % numitems, item2 = rng() % numitems;
+				if(item1 != item2){
+					diffs.push_back(make_pair(item1, item2));
+				}
+			}
+			conflict_graph conflict(numitems, diffs);
+			dominance_index dominance(mus, bs, numitems); // built with the merged items in the pricer
+
+			vector<int> items_bin, items_bin_rescan;
+			vector<pair<SCIP_Real, vector<int>>> packings;
+			SCIP_Real sol_val = 0, sol_val_rescan = 0;
+			work_budget budget;
+			auto start = chrono::steady_clock::now();
+			solve_conic_knap_best_fit(objs, mus, bs, Dalpha, capacity, numitems, conflict, dominance, num_threads, budget, start, 1e9,
+				numeric_limits<SCIP_Real>::infinity(), items_bin, sol_val, packings);
+			sum_ms += chrono::duration<SCIP_Real, milli>(chrono::steady_clock::now() - start).count();
+			start = chrono::steady_clock::now();
+			best_fit_rescan(objs, mus, bs, Dalpha, capacity, numitems, conflict, items_bin_rescan, sol_val_rescan);
+			sum_ms_rescan += chrono::duration<SCIP_Real, milli>(chrono::steady_clock::now() - start).count();
+			if(items_bin != items_bin_rescan){
+				num_differ++;
+			}
+		}
+		printf("%8d %16.3f %16.3f %10d\n", numitems, sum_ms / num_problems, sum_ms_rescan / num_problems, num_differ);
+	}
+	return 0;
+}
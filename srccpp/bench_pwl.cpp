@@ -0,0 +1,88 @@
+/**@file   bench_pwl.cpp
+ * @brief  Benchmark of the formulations of the piecewise linear relaxation of the PWLBC
+ * @author Liding Xu
+ *
+ * usage: bench_pwl record_file [time_limit] [max_problems]
+ * The pricing problems are recorded by cbp with the parameter cbp/pricing_record.
+ * Each problem is solved by the relaxation with the SOC cuts (solve_conic_rel_milp_cut) for every formulation of cbp/pwl_formulation
+ * and every number of breakpoints, the mean and the maximal solving times, the mean deterministic ticks and the numbers of optimal solves are printed.
+ *---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <list>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include "conic_knapsack_pwlbc.h"
+
+using namespace std;
+
+static const char * formulation_names[] = {"", "cplex pwl", "sos2", "incremental", "multi-choice"};
+
+int main(int argc, char ** argv){
+	if(argc < 2){
+		cerr << "usage: " << argv[0] << " record_file [time_limit] [max_problems]" << endl;
+		return 1;
+	}
+	ifstream in(argv[1]);
+	SCIP_Real time_limit = argc > 2 ? atof(argv[2]) : 10;
+	int max_problems = argc > 3 ? atoi(argv[3]) : 100;
+	const int num_counts = 5;
+	const int point_counts[num_counts] = {10, 20, 40, 80, 160};
+
+	// times[count][formulation], optimal solves and disagreements of the optimal values with the CPLEX piecewise linear function
+	vector<vector<SCIP_Real>> sum_times(num_counts, vector<SCIP_Real>(5, 0)), max_times(num_counts, vector<SCIP_Real>(5, 0)), sum_ticks(num_counts, vector<SCIP_Real>(5, 0));
+	vector<vector<int>> num_optimal(num_counts, vector<int>(5, 0)), num_differ(num_counts, vector<int>(5, 0));
+	int num_problems = 0;
+	vector<SCIP_Real> objs, mus, bs;
+	vector<pair<int, int>> diffs;
+	SCIP_Real Dalpha, capacity, target_lb;
+	int numitems;
+	while(num_problems < max_problems && read_pricing(in, objs, mus, bs, Dalpha, capacity, numitems, diffs, target_lb)){
+		conflict_graph conflict(numitems, diffs);
+		for(int c = 0; c < num_counts; c++){
+			SCIP_Real ref_val = -1;
+			for(int formulation = 1; formulation <= 4; formulation++){
+				conf algo_conf;
+				algo_conf.pwl_formulation = formulation;
+				algo_conf.is_mip_start = false;
+				algo_conf.cut_pool_size = 0;
+				BreakPoints breakpoints(capacity, 0, capacity, point_counts[c]);
+				cplex_model model;
+				stat stat_prc;
+				list<list<int>> sol_pool;
+				pair<SCIP_Real, SCIP_Real> mubd;
+				SCIP_Real sol_val = 0, sol_ub = MAXFLOAT, mu_val_rel = 0, sol_time = 0;
+				SOLTYPE_CKNAP sol_type = Unknown;
+				work_budget budget;
+				solve_conic_rel_milp_cut(objs, mus, bs, Dalpha, capacity, numitems, conflict, breakpoints, model, list<vector<int>>(), algo_conf,
+					time_limit, target_lb, sol_pool, mubd, sol_val, sol_ub, sol_type, mu_val_rel, sol_time, stat_prc, budget);
+				sum_times[c][formulation] += sol_time;
+				sum_ticks[c][formulation] += budget.used();
+				max_times[c][formulation] = max(max_times[c][formulation], sol_time);
+				if(sol_type == Optimal || sol_type == Infeasible){
+					num_optimal[c][formulation]++;
+					SCIP_Real val = sol_type == Optimal ? sol_val : 0;
+					if(formulation == 1){
+						ref_val = val;
+					}
+					else if(ref_val >= 0 && fabs(val - ref_val) > 1e-6 * max(1.0, fabs(ref_val))){
+						num_differ[c][formulation]++;
+					}
+				}
+			}
+		}
+		num_problems++;
+	}
+	printf("%d pricing problems, time limit %.1f s\n", num_problems, time_limit);
+	printf("%12s %14s %12s %12s %12s %10s %10s\n", "breakpoints", "formulation", "mean time", "max time", "mean ticks", "optimal", "differ");
+	for(int c = 0; c < num_counts; c++){
+		for(int formulation = 1; formulation <= 4; formulation++){
+			printf("%12d %14s %12.4f %12.4f %12.2f %10d %10d\n", point_counts[c], formulation_names[formulation],
+				num_problems > 0 ? sum_times[c][formulation] / num_problems : 0.0, max_times[c][formulation],
+				num_problems > 0 ? sum_ticks[c][formulation] / num_problems : 0.0, num_optimal[c][formulation], num_differ[c][formulation]);
+		}
+	}
+	return 0;
+}
@@ -9,15 +9,19 @@
 #include <vector>
 #include <algorithm>
 #include <list>
+#include <thread>
 #include <ilcplex/ilocplex.h>
 #include "conic_knapsack.h"
 #include "conic_knapsack_heur.h"
 #include "conic_knapsack_pwlbc.h"
+#include "conic_knapsack_dp.h"
+#include "conic_knapsack_bb.h"
 
 
 
 /** solve conic knapsack problem by cplex before timie_limit,
 *   find a solution with value greater than the tagret lower bound, and store the solution
+*   the model is built in the first call and kept in model, the next calls only update the objective and the target row.
 *   possible return values for:
 *  - Sol_Ge_Bd : a solution with value greater than the tagret lower bound is found
 *  - No_Sol_Ge_Bd :  no solution with value greater than the tagret lower bound
@@ -31,60 +35,90 @@ void solve_micp(
 	SCIP_Real capacity, /** capacity */
 	int numitems, /** number of items */
    conf algo_conf, /** algorithm configuration */
-	const vector<pair<int,int>>& items_diff, /** items in same constraints */
+	const conflict_graph & conflict, /** the conflict graph*/
+	cplex_model & model, /** the persistent MISOCP model */
+	const list<vector<int>> & mip_starts, /** feasible packings passed as MIP starts, sorted items */
 	list<list<int>> & sol_pool, /* items in the maximal bin, assumed to be sorted */
    SCIP_Real & sol_val, /** solution value */
    SCIP_Real & sol_ub, /** solution value upper bound*/
 	SOLTYPE_CKNAP & sol_type, /** solution type */
+   work_budget & budget, /** the work budget */
    SCIP_Real time_limit,  /** solving time left */
    SCIP_Real target_lb /* the tagret lower bound bound  */
 ){
-   IloEnv env;
-
+   if(model.built && !model.same_structure(mus, bs, Dalpha, capacity, numitems, conflict)){
+      model.clear();
+   }
+   IloEnv env = model.env;
 
    try {
-      // Create the model, populate by row
-      IloModel model(env);
-      IloCplex cplex(env);
-      IloNumVarArray x_vars(env, numitems);
-      IloNumVarArray xc_vars(env, numitems);
-      IloNumVar z(env, 0.0, IloInfinity, ILOFLOAT); 
-         
-
-      IloExpr expr_sum_mu_x(env);
-      IloExpr expr_sum_xc2(env);
-      IloExpr expr_obj(env);
-      for(int item = 0; item < numitems; item++){
-         x_vars[item] = IloNumVar(env, 0.0, 1.0, ILOBOOL); // add the binary variable for knapsack
-         xc_vars[item] = IloNumVar(env, 0.0, sqrt(bs[item]), ILOFLOAT); // add the continuous variable for knapsack
-         model.add(sqrt(bs[item]) * x_vars[item] <= xc_vars[item]); // add the coupling constraint for knapsack
-         expr_sum_mu_x +=  mus[item] * x_vars[item];
-         expr_sum_xc2 += xc_vars[item]*xc_vars[item];
-         expr_obj += objs[item] * x_vars[item];      
-      }
-
-      // add the same and different constraints
-      for(auto pair_item: items_diff){
-         model.add(x_vars[pair_item.first] + x_vars[pair_item.second] <= 1);
-      } 
-      model.add(  expr_sum_mu_x +  Dalpha *z  <= capacity); 
-      model.add( expr_sum_xc2 <= z*z ); // second order cone constraint
-      model.add(  expr_obj   >= target_lb - tol); 
-      model.add(IloMaximize(env, expr_obj)); // set the maximization objective
-
-      // Extract model.
-
-      cplex.extract(model);
-
-
-      // set the time limit in CPU seconds
-      cplex.setParam(IloCplex::Param::ClockType, 1);
-      cplex.setParam(IloCplex::Param::TimeLimit, time_limit);
-      cplex.setParam(IloCplex::Param::Threads, algo_conf.is_parallelscplex ? 0 : 1);
-      cplex.setOut(env.getNullStream());
+      if(!model.built){
+         // Create the model, populate by row
+         model.model = IloModel(env);
+         model.cplex = IloCplex(env);
+         model.x_vars = IloNumVarArray(env, numitems);
+         model.set_structure(mus, bs, Dalpha, capacity, numitems, conflict);
+         IloNumVarArray & x_vars = model.x_vars;
+         IloNumVarArray xc_vars(env, numitems);
+         IloNumVar z(env, 0.0, IloInfinity, ILOFLOAT); 
+            
+
+         IloExpr expr_sum_mu_x(env);
+         IloExpr expr_sum_xc2(env);
+         IloExpr expr_obj(env);
+         for(int item = 0; item < numitems; item++){
+            x_vars[item] = IloNumVar(env, 0.0, 1.0, ILOBOOL); // add the binary variable for knapsack
+            xc_vars[item] = IloNumVar(env, 0.0, sqrt(bs[item]), ILOFLOAT); // add the continuous variable for knapsack
+            model.model.add(sqrt(bs[item]) * x_vars[item] <= xc_vars[item]); // add the coupling constraint for knapsack
+            expr_sum_mu_x +=  mus[item] * x_vars[item];
+            expr_sum_xc2 += xc_vars[item]*xc_vars[item];
+            expr_obj += objs[item] * x_vars[item];      
+         }
+
+         // add the same and different constraints
+         for(int item = 0; item < numitems; item++){
+            for(int item_: conflict.get_diffs(item)){
+               if(item < item_){
+                  model.model.add(x_vars[item] + x_vars[item_] <= 1);
+               }
+            }
+         }
+         model.model.add(  expr_sum_mu_x +  Dalpha *z  <= capacity); 
+         model.model.add( expr_sum_xc2 <= z*z ); // second order cone constraint
+         model.target_row = IloRange(env, target_lb - tol, expr_obj, IloInfinity);
+         model.model.add(model.target_row); 
+         model.obj = IloMaximize(env, expr_obj);
+         model.model.add(model.obj); // set the maximization objective
+
+         // Extract model.
+
+         model.cplex.extract(model.model);
+         model.cplex.setParam(IloCplex::Param::ClockType, 1);
+         model.cplex.setOut(env.getNullStream());
+         model.aborter = IloCplex::Aborter(env);
+         model.cplex.use(model.aborter);
+         if(algo_conf.exact_abort_ratio < 1){ // stop at the good incumbents
+            AbortCallback * cb = new AbortCallback(model);
+            model.callbacks.push_back(cb);
+            model.cplex.use(cb, IloCplex::Callback::Context::Id::GlobalProgress);
+         }
+         model.built = true;
+      }
+      else{
+         model.update(objs, target_lb);
+      }
+      IloCplex & cplex = model.cplex;
+      IloNumVarArray & x_vars = model.x_vars;
+
+
+      cplex.setParam(IloCplex::Param::Threads, algo_conf.is_parallelscplex ? model.num_threads : 1);
+      if(algo_conf.is_mip_start){
+         model.set_mip_starts(objs, mip_starts, target_lb);
+      }
 
       sol_type = Unknown;
-      cplex.solve();
+      model.aborted = false;
+      model.solve(budget, time_limit); // the time limit in CPU seconds
       if( cplex.getStatus() ==  IloAlgorithm::Infeasible){
          sol_type = Infeasible;
       }
@@ -96,6 +130,7 @@ void solve_micp(
                }
          }
          sol_pool.push_back(items_bin);
+         model.harvest_pool(objs, mus, bs, Dalpha, capacity, target_lb, algo_conf.exact_columns, sol_pool);
          sol_val =  cplex.getObjValue();
          sol_ub = cplex.getBestObjValue();
          SCIPdebugMessage("%lf %lf\n", sol_val, sol_ub);
@@ -109,21 +144,185 @@ void solve_micp(
       else{
          cout << "none";
       }
-      env.end();
    } catch (IloException &e) {
       cerr << "IloException: " << e << endl;
-      if (env.getImpl())
-         env.end();
+      model.clear();
       ::abort();
    } catch (string& e) {
       cerr << e << endl;
-      if (env.getImpl())
-         env.end();
+      model.clear();
       ::abort();
    }  
 }
 
 
+/** the solving time left of SCIP, it is read by the callers of the PWLBC since the PWLBC does not call SCIP */
+static SCIP_Real get_time_left(
+   SCIP * scip /** scip pointer */
+){
+   SCIP_Real time_left;
+   SCIPgetRealParam(scip, "limits/time", &time_left);
+   return SCIPisInfinity(scip, time_left) ? 1e75 : time_left - SCIPgetSolvingTime(scip);
+}
+
+
+/* the algorithms of the pricing portfolio */
+enum race_algo{
+   Race_Heur = 0,
+   Race_PWLBC = 1,
+   Race_MICP = 2
+};
+
+
+/* the result of an algorithm of the pricing portfolio */
+struct race_result{
+   list<list<int>> sol_pool; /* solutions pools, solution items are assumed to be sorted */
+   SCIP_Real sol_val = 0; /** solution value */
+   SCIP_Real sol_ub = MAXFLOAT; /** solution value upper bound */
+   SOLTYPE_CKNAP sol_type = Unknown; /** solution type */
+   stat stat_racer; /** statistic of the PWLBC, added to the statistic of pricing after the race */
+   vector<pair<SCIP_Real, SCIP_Real>> mu_samples; /** the ranges of mu learned by the PWLBC, added to the estimator after the race */
+};
+
+
+/** solve conic knapsack problem by the pricing portfolio: the heuristic runs in this thread, the PWLBC and/or the MISOCP in their own threads.
+*   The first algorithm deciding the round wins it, the heuristic by a column that needs no exact pricing, an exact algorithm by an optimal,
+*   an infeasible or an aborted solve with columns, and the others are cancelled. If none decides, the columns of the heuristic are returned.
+*   The exact algorithms only get the packings of the last rounds as MIP starts. The racers do not call SCIP, and their statistics and estimator samples
+*   are applied after the race. With parallel CPLEX, the cores left by the heuristic threads are split between the CPLEX racers.
+*/
+static void solve_conic_knap_portfolio(
+	SCIP * scip, /** scip pointer */
+	stat & stat_prc, /** statistic of pricing */
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems, /** number of items */
+   Estimator & init_estimator, /** initial estimator*/
+   const conflict_graph & conflict, /** the conflict graph*/
+	const dominance_index & dominance, /** the dominance index of the items */
+	pricing_model & pr_model, /** the persistent CPLEX models of the node */
+	const list<vector<int>> & warm_starts, /** packings of the last pricing rounds, sorted items */
+	const conf & algo_conf, /** algorithm configuration*/
+   list<list<int>> & sol_pool, /* solutions pools, solution items are assumed to be sorted */
+   SCIP_Real & sol_val, /** solution value */
+   SCIP_Real & sol_ub, /** solution value */
+	SOLTYPE_CKNAP & sol_type, /** solution type */
+   SCIP_Real stop_pricing_obj, // if the optimal  value of pricing solution is <= stop_pricing_obj, early stops
+   SCIP_Real rel_bound, /** the continuous relaxation bound */
+   SCIP_Real work_limit, /** work units of each algorithm */
+   SCIP_Real time_limit,  /** solving time left of the heuristic */
+   SCIP_Real cplex_time_limit,  /** solving time left of CPLEX */
+   SCIP_Real target_lb /* the tagret lower bound bound  */
+){
+   pricing_race race;
+   race_result results[3];
+   work_budget budget_heur(work_limit, &race.decided), budget_pwlbc(work_limit, &race.decided), budget_micp(work_limit, &race.decided);
+   bool is_pwlbc = algo_conf.portfolio == 2 || !algo_conf.is_misocp;
+   bool is_micp = algo_conf.portfolio == 2 || algo_conf.is_misocp;
+   SCIP_Real algo_ratio = (stat_prc.col_heur + 0.0) / stat_prc.col_exact;
+   list<vector<int>> mip_starts;
+   if(algo_conf.is_mip_start){
+      mip_starts = warm_starts;
+   }
+   SCIP_Real scip_time_left = get_time_left(scip);
+   int num_cplex_threads = max(1, (int(thread::hardware_concurrency()) - (algo_conf.is_heur ? algo_conf.heur_threads : 0)) / (int(is_pwlbc) + int(is_micp)));
+   for(cplex_model * model: {&pr_model.rel, &pr_model.micp}){
+      model->num_threads = num_cplex_threads;
+      model->abort_lb = algo_conf.exact_abort_ratio < 1 ? max(target_lb + tol, stop_pricing_obj) : MAXFLOAT;
+      model->abort_ratio = algo_conf.exact_abort_ratio;
+      model->aborted = false;
+      model->race = &race;
+   }
+   auto decides = [](const race_result & result){
+      return result.sol_type == Infeasible || result.sol_type == Optimal || (result.sol_type == Feasible_Exact && !result.sol_pool.empty());
+   };
+   auto run_pwlbc = [&](){
+      race_result & result = results[Race_PWLBC];
+      solve_conic_knap_pwlbc(result.stat_racer, objs,  mus,  bs,  Dalpha,  capacity,  numitems,  init_estimator, algo_conf, -1, conflict, pr_model.rel, mip_starts, result.sol_pool,  
+         result.sol_val,  result.sol_ub, result.sol_type, result.mu_samples, budget_pwlbc, scip_time_left, cplex_time_limit,  target_lb);
+      if(decides(result)){
+         race.decide(Race_PWLBC);
+      }
+   };
+   auto run_micp = [&](){
+      race_result & result = results[Race_MICP];
+      solve_micp(objs, mus, bs, Dalpha, capacity, numitems, algo_conf, conflict, pr_model.micp, mip_starts, result.sol_pool, result.sol_val, result.sol_ub, 
+         result.sol_type, budget_micp, cplex_time_limit, target_lb);
+      if(decides(result)){
+         race.decide(Race_MICP);
+      }
+   };
+
+   SCIP_Real time_a = SCIPgetSolvingTime(scip);
+   vector<thread> racers;
+   if(is_pwlbc){
+      racers.emplace_back(run_pwlbc);
+   }
+   if(is_micp){
+      racers.emplace_back(run_micp);
+   }
+   if(algo_conf.is_heur){
+      race_result & result = results[Race_Heur];
+      solve_conic_knap_heur(objs, mus, bs, Dalpha, capacity, numitems, conflict, dominance, warm_starts, algo_conf, result.sol_pool, result.sol_val, budget_heur, time_limit, target_lb);
+      if(result.sol_val > target_lb + tol && !result.sol_pool.empty()){
+         result.sol_type = Feasible_Heur;
+         result.sol_ub = rel_bound;
+         // no need for exact pricing, after the first exact round as in the sequential pricing
+         if(result.sol_val > stop_pricing_obj && algo_ratio < MAXFLOAT){
+            race.decide(Race_Heur);
+         }
+      }
+   }
+   for(thread & racer: racers){
+      racer.join();
+   }
+   SCIP_Real time_b = SCIPgetSolvingTime(scip);
+   for(cplex_model * model: {&pr_model.rel, &pr_model.micp}){
+      model->race = NULL;
+      model->num_threads = 0;
+   }
+   const stat & stat_pwlbc = results[Race_PWLBC].stat_racer;
+   stat_prc.cum_knn_time += stat_pwlbc.cum_knn_time;
+   stat_prc.cum_sol_time += stat_pwlbc.cum_sol_time;
+   stat_prc.num_mu_track += stat_pwlbc.num_mu_track;
+   stat_prc.time_mu_track += stat_pwlbc.time_mu_track;
+   for(const pair<SCIP_Real, SCIP_Real> & mubd: results[Race_PWLBC].mu_samples){
+      init_estimator.add(objs, mubd);
+   }
+
+   int winner = race.winner;
+   stat_prc.work_heur += budget_heur.used();
+   stat_prc.work_exact += budget_pwlbc.used() + budget_micp.used();
+   if(winner == -1){
+      stat_prc.race_none++;
+      winner = Race_Heur; // its columns if any
+   }
+   race_result & result = results[winner];
+   sol_pool.splice(sol_pool.end(), result.sol_pool);
+   sol_val = result.sol_val;
+   sol_ub = result.sol_ub;
+   sol_type = result.sol_type;
+   if(race.winner == Race_Heur){
+      stat_prc.race_heur++;
+      stat_prc.col_heur++;
+      stat_prc.time_heur += time_b - time_a;
+   }
+   else if(race.winner != -1){
+      (race.winner == Race_PWLBC ? stat_prc.race_pwlbc : stat_prc.race_micp)++;
+      SCIP_Real relative_gap = fabs(sol_val- sol_ub)/fabs(max(sol_val, sol_ub)) * 100;
+      stat_prc.shf_log_sum_gap += log(stat_prc.shf_param + relative_gap);
+      stat_prc.col_exact++;
+      stat_prc.time_exact += time_b - time_a;
+      if((race.winner == Race_PWLBC ? pr_model.rel : pr_model.micp).aborted){
+         stat_prc.col_abort++;
+      }
+   }
+}
+
+
 /** solve conic knapsack problem before timie_limit,
 *   find a solution with value greater than the tagret lower bound, and store the solution
 *   possible return values for:
@@ -142,8 +341,10 @@ void solve_conic_knap(
 	int numitems, /** number of items */
    Estimator & init_estimator, /** initial estimator*/
    const vector<pair<int,int>>& items_same, /** items in same constraints */
-	const vector<pair<int,int>>& items_diff, /** items in same constraints */
    const conflict_graph & conflict, /** the conflict graph*/
+	const dominance_index & dominance, /** the dominance index of the items */
+	pricing_model & pr_model, /** the persistent CPLEX models of the node */
+	const list<vector<int>> & warm_starts, /** packings of the last pricing rounds, sorted items */
 	const conf & algo_conf, /** algorithm configuration*/
    list<list<int>> & sol_pool, /* solutions pools, solution items are assumed to be sorted */
    SCIP_Real & sol_val, /** solution value */
@@ -157,32 +358,108 @@ void solve_conic_knap(
       SCIP_Real time_a, time_b;
       SCIP_Real summu = -1;
       SCIP_Real alpha = 0.3;
+      list<vector<int>> mip_starts; // packings of the heuristic and of the last rounds passed to the exact pricing
+      SCIP_Real rel_bound = MAXFLOAT;
+      // with deterministic budgets, each algorithm gets the work of its time budget, and CPLEX is only limited by the time left of the solve
+      SCIP_Real work_limit = numeric_limits<SCIP_Real>::infinity();
+      SCIP_Real cplex_time_limit = time_limit;
+      if(algo_conf.work_rate > 0){
+         work_limit = time_limit * algo_conf.work_rate;
+         cplex_time_limit = max(get_time_left(scip), 0.0);
+      }
+      // the continuous relaxation bound, no improving column exists if it is below the target, with the tolerance of the exact pricing
+      if(algo_conf.is_rel_bound){
+         time_a = SCIPgetSolvingTime(scip);
+         rel_bound = conic_relaxation_bound(objs, mus, bs, Dalpha, capacity, numitems);
+         time_b = SCIPgetSolvingTime(scip);
+         stat_prc.time_bound += time_b - time_a;
+         if(rel_bound < target_lb - tol){
+            sol_type = Infeasible;
+            sol_val = 0;
+            sol_ub = rel_bound;
+            stat_prc.col_bound++;
+            return;
+         }
+      }
+      // race the heuristic and the exact algorithms in the rounds that the dynamic programming and the branch and bound do not solve
+      bool is_dp_round = algo_conf.is_dp && conflict.num_diffs() == 0 && numitems <= algo_conf.dp_max_items;
+      if(algo_conf.portfolio > 0 && !is_dp_round && numitems > algo_conf.bb_max_items){
+         solve_conic_knap_portfolio(scip, stat_prc, objs, mus, bs, Dalpha, capacity, numitems, init_estimator, conflict, dominance, pr_model, warm_starts, 
+            algo_conf, sol_pool, sol_val, sol_ub, sol_type, stop_pricing_obj, rel_bound, work_limit, time_limit, cplex_time_limit, target_lb);
+         return;
+      }
       time_a = SCIPgetSolvingTime(scip);
       //SCIPdebugMessage("is heur%d %d %d \n", int(algo_conf.is_heur), int(algo_conf.is_misocp), int(algo_conf.is_parallelscplex));
       if(algo_conf.is_heur)
       {
       // fix some variable with zero objectives
          SCIP_Real sol_val_heur = 0;
-         vector<int> items_bin_heur;
+         list<list<int>> sol_pool_heur;
+         work_budget budget(work_limit);
          // solve heuristics
-         solve_conic_knap_heur(objs, mus, bs, Dalpha, capacity, numitems, items_diff, conflict, items_bin_heur, sol_val_heur, time_limit, target_lb);
-         for(int item :  items_bin_heur){
-            summu += mus[item];
+         solve_conic_knap_heur(objs, mus, bs, Dalpha, capacity, numitems, conflict, dominance, warm_starts, algo_conf, sol_pool_heur, sol_val_heur, budget, time_limit, target_lb);
+         stat_prc.work_heur += budget.used();
+         if(!sol_pool_heur.empty()){
+            for(int item :  sol_pool_heur.front()){
+               summu += mus[item];
+            }
          }
          SCIP_Real  algo_ratio = (stat_prc.col_heur + 0.0) / stat_prc.col_exact;
          // no need for exact pricing
          if(sol_val_heur > target_lb + tol && sol_val_heur > stop_pricing_obj && algo_ratio < MAXFLOAT){
             sol_type = Feasible_Heur;
             sol_val = sol_val_heur;
-            sol_pool.push_back(list<int>(items_bin_heur.begin(), items_bin_heur.end()));
+            sol_ub = rel_bound;
             stat_prc.col_heur++;
+            sol_pool.splice(sol_pool.end(), sol_pool_heur);
             //SCIPdebugMessage("%f/%f\n", summu, capacity);
             time_b = SCIPgetSolvingTime(scip);
             stat_prc.time_heur += time_b - time_a;
             return;
          }
+         if(algo_conf.is_mip_start){
+            for(const list<int> & packing: sol_pool_heur){
+               mip_starts.push_back(vector<int>(packing.begin(), packing.end()));
+            }
+         }
+      }
+      if(algo_conf.is_mip_start){
+         mip_starts.insert(mip_starts.end(), warm_starts.begin(), warm_starts.end());
+      }
+
+
+      // solve the pricing problem without conflicts by the profit scaling dynamic programming
+      if(is_dp_round){
+         sol_val= 0;
+         sol_ub = MAXFLOAT;
+         time_a = SCIPgetSolvingTime(scip);
+         work_budget budget(work_limit);
+         solve_conic_knap_dp(objs, mus, bs, Dalpha, capacity, numitems, algo_conf.dp_eps, sol_pool, sol_val, sol_ub, sol_type, budget, time_limit, target_lb);
+         time_b = SCIPgetSolvingTime(scip);
+         stat_prc.time_dp += time_b - time_a;
+         stat_prc.work_dp += budget.used();
+         if(sol_type != Unknown && sol_type != Aborted){
+            stat_prc.col_dp++;
+            return;
+         }
       }
 
+      // solve the small pricing problems by the combinatorial branch and bound
+      if(numitems <= algo_conf.bb_max_items){
+         sol_val= 0;
+         sol_ub = MAXFLOAT;
+         time_a = SCIPgetSolvingTime(scip);
+         work_budget budget(work_limit);
+         solve_conic_knap_bb(objs, mus, bs, Dalpha, capacity, numitems, conflict, algo_conf.exact_columns, sol_pool, sol_val, sol_ub, sol_type, budget, time_limit, target_lb);
+         time_b = SCIPgetSolvingTime(scip);
+         stat_prc.time_bb += time_b - time_a;
+         stat_prc.work_bb += budget.used();
+         if(sol_type != Unknown && sol_type != Aborted){
+            stat_prc.col_bb++;
+            stat_prc.col_exact++; // an exact pricing round for the hybrid pricing strategy
+            return;
+         }
+      }
 
       // use quadratic Estimator to solve MILP relaxation
       
@@ -191,8 +468,13 @@ void solve_conic_knap(
       sol_type = Unknown;
       time_a = SCIPgetSolvingTime(scip);
       SCIP_Real relative_gap = 100;
+      // CPLEX may stop at the first column good enough for the column generation, the rounds where the Farley bound may stop it are solved to optimality
+      cplex_model & exact_model = algo_conf.is_misocp ? pr_model.micp : pr_model.rel;
+      exact_model.abort_lb = algo_conf.exact_abort_ratio < 1 ? max(target_lb + tol, stop_pricing_obj) : MAXFLOAT;
+      exact_model.abort_ratio = algo_conf.exact_abort_ratio;
+      work_budget budget(work_limit);
       if(algo_conf.is_misocp){ // BSOCP
-         solve_micp(objs, mus, bs, Dalpha, capacity, numitems, algo_conf, items_diff,  sol_pool, sol_val, sol_ub,  sol_type, time_limit, target_lb);   
+         solve_micp(objs, mus, bs, Dalpha, capacity, numitems, algo_conf, conflict, pr_model.micp, mip_starts, sol_pool, sol_val, sol_ub,  sol_type, budget, cplex_time_limit, target_lb);   
          relative_gap = fabs(sol_val- sol_ub)/fabs(max(sol_val, sol_ub)) * 100;
          stat_prc.shf_log_sum_gap += log(stat_prc.shf_param + relative_gap);
          stat_prc.col_exact++;
@@ -203,8 +485,12 @@ void solve_conic_knap(
       }
       else{
          // PWLBC
-         solve_conic_knap_pwlbc(scip, stat_prc, objs,  mus,  bs,  Dalpha,  capacity,  numitems,  init_estimator, algo_conf, summu, items_diff,  conflict,  sol_pool,  
-         sol_val,  sol_ub, sol_type,  time_limit ,  target_lb);;
+         vector<pair<SCIP_Real, SCIP_Real>> mu_samples;
+         solve_conic_knap_pwlbc(stat_prc, objs,  mus,  bs,  Dalpha,  capacity,  numitems,  init_estimator, algo_conf, summu, conflict, pr_model.rel, mip_starts, sol_pool,  
+         sol_val,  sol_ub, sol_type, mu_samples, budget, get_time_left(scip), cplex_time_limit ,  target_lb);
+         for(const pair<SCIP_Real, SCIP_Real> & mubd: mu_samples){
+            init_estimator.add(objs, mubd);
+         }
          relative_gap = fabs(sol_val- sol_ub)/fabs(max(sol_val, sol_ub)) * 100;
          stat_prc.shf_log_sum_gap += log(stat_prc.shf_param + relative_gap);
          stat_prc.col_exact++;
@@ -212,6 +498,10 @@ void solve_conic_knap(
          //SCIPdebugMessage("%f %d\n", time_b - time_a, cut_pool.size()); 
          stat_prc.time_exact += time_b - time_a;
       }
+      stat_prc.work_exact += budget.used();
+      if(exact_model.aborted){
+         stat_prc.col_abort++;
+      }
    }
    else{
       SCIPdebugMessage("linear binpack not callable\b");
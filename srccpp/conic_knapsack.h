@@ -6,9 +6,31 @@
 #include <utility>
 #include "estimator.h"
 #include "utilities.h"
+#include "pricing_model.h"
 using namespace std;
 
 
+/** solve conic knapsack problem by the MISOCP with CPLEX before time_limit, the model is kept in model for the next rounds */
+void solve_micp(
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems, /** number of items */
+	conf algo_conf, /** algorithm configuration */
+	const conflict_graph & conflict, /** the conflict graph*/
+	cplex_model & model, /** the persistent MISOCP model */
+	const list<vector<int>> & mip_starts, /** feasible packings passed as MIP starts, sorted items */
+	list<list<int>> & sol_pool, /* items in the maximal bin, assumed to be sorted */
+	SCIP_Real & sol_val, /** solution value */
+	SCIP_Real & sol_ub, /** solution value upper bound*/
+	SOLTYPE_CKNAP & sol_type, /** solution type */
+	work_budget & budget, /** the work budget */
+	SCIP_Real time_limit,  /** solving time left */
+	SCIP_Real target_lb /* the tagret lower bound bound  */
+);
+
 /** solve conic knapsack problem before timie_limit,
 *   find a solution with value greater than the tagret lower bound, and store the solution
 *   possible return values for:
@@ -27,8 +49,10 @@ void solve_conic_knap(
 	int numitems, /** number of items */
 	Estimator & init_estimator, /** initial estimator*/
 	const vector<pair<int,int>>& items_same, /** items in same constraints */
-	const vector<pair<int,int>>& items_diff, /** items in same constraints */
 	const conflict_graph & conflict, /** the conflict graph*/
+	const dominance_index & dominance, /** the dominance index of the items */
+	pricing_model & pr_model, /** the persistent CPLEX models of the node */
+	const list<vector<int>> & warm_starts, /** packings of the last pricing rounds, sorted items */
 	const conf & algo_conf, /** algorithm configuration*/
     list<list<int>> & sol_pool, /* solutions pools, solution items are assumed to be sorted */
 	SCIP_Real & sol_val, /** solution value */
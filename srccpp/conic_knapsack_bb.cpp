@@ -0,0 +1,442 @@
+/**@file   conic_knapsack_bb.cpp
+ * @brief  Conic Knapsack combinatorial branch and bound and relaxation bound
+ * @author Liding Xu
+ *---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+#include <vector>
+#include <list>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include "conic_knapsack_bb.h"
+
+#define BB_CHECK_NODES 1024 /* number of nodes between two checks of the budget */
+#define BB_NODE_STEPS 2 /* steps of the budget charged for a node */
+
+
+/* a node of the depth first search, the items before pos are decided */
+struct bb_frame{
+	int pos; /** position of the next item to decide */
+	int stage; /** 0: not visited, 1: the item is packed in the child, 2: the item is excluded in the child */
+	SCIP_Real summu; /** mu of the packed items */
+	SCIP_Real sumb; /** b of the packed items */
+	SCIP_Real val; /** value of the packed items */
+};
+
+
+/* arrays of the branch and bound, kept by each thread and reused by the next calls */
+struct bb_arena{
+	vector<int> order; // candidate items in the branching order
+	vector<SCIP_Real> p_objs, p_mus, p_bs; // objective coefficients, mu and b of the candidates by position
+	vector<int> blocked; // number of packed items conflicting with the items
+	vector<int> forced; // number of excluded items dominating the positions
+	vector<int> dominated_offsets; // the positions dominated by the position p are dominated[dominated_offsets[p]], ..., dominated[dominated_offsets[p + 1] - 1]
+	vector<int> dominated;
+	vector<int> path; // packed items of the current node
+	vector<bb_frame> frames; // stack of the depth first search
+	vector<int> frees; // positions of the free candidates in the bound
+	vector<pair<SCIP_Real, SCIP_Real>> pieces; // (ratio, weight) of the free candidates in the bound
+	vector<list<int>> incumbents; // improving packings, increasing values
+};
+
+static thread_local bb_arena arena;
+
+
+/** upper bound of the packings of the node, the conic constraint is relaxed to a linear knapsack constraint by the secant of sqrt
+ *   over [sumb, b_hi], b_hi = min(((capacity - summu) / Dalpha)^2, sumb + b of the free candidates fitting alone):
+ *   D sqrt(sumb + b x) >= D sqrt(sumb) + D b x / (sqrt(b_hi) + sqrt(sumb)),
+ *   and the bound is the fractional knapsack bound over the free candidates fitting alone.
+*/
+static SCIP_Real node_bound(
+	const bb_frame & frame, /** the node */
+	int numcands, /** number of candidates */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	SCIP_Real threshold /** packings with values at most threshold are not needed */
+){
+	SCIP_Real sum_objs = 0, sum_bs = 0;
+	arena.frees.clear();
+	for(int p = frame.pos; p < numcands; p++){
+		if(arena.blocked[arena.order[p]] > 0 || arena.forced[p] > 0){
+			continue;
+		}
+		if(frame.summu + arena.p_mus[p] + Dalpha * sqrt(frame.sumb + arena.p_bs[p]) > capacity){
+			continue;
+		}
+		arena.frees.push_back(p);
+		sum_objs += arena.p_objs[p];
+		sum_bs += arena.p_bs[p];
+	}
+	if(frame.val + sum_objs <= threshold){
+		return frame.val + sum_objs;
+	}
+	SCIP_Real sqrt_b = sqrt(frame.sumb);
+	SCIP_Real rem = capacity - frame.summu - Dalpha * sqrt_b;
+	SCIP_Real denom = min((capacity - frame.summu) / Dalpha, sqrt(frame.sumb + sum_bs)) + sqrt_b;
+	arena.pieces.clear();
+	for(int p: arena.frees){
+		SCIP_Real weight = arena.p_mus[p] + Dalpha * arena.p_bs[p] / denom;
+		arena.pieces.push_back(make_pair(arena.p_objs[p] / max(weight, 1e-12), weight));
+	}
+	sort(arena.pieces.begin(), arena.pieces.end(), [](const pair<SCIP_Real, SCIP_Real> & piece1, const pair<SCIP_Real, SCIP_Real> & piece2){
+		return piece1.first > piece2.first;
+	});
+	SCIP_Real bound = frame.val;
+	for(const pair<SCIP_Real, SCIP_Real> & piece: arena.pieces){
+		if(piece.second <= rem){
+			rem -= piece.second;
+			bound += piece.first * piece.second;
+		}
+		else{
+			bound += piece.first * rem;
+			break;
+		}
+	}
+	return bound;
+}
+
+
+/** solve conic knapsack problem with conflicts by a depth first branch and bound before time_limit.
+ *   The candidates are the items with positive objectives fitting alone, ordered by decreasing objs / (mu + Dalpha^2 b / capacity).
+ *   The search packs the item of a node first, then excludes it, the nodes are pruned by the secant relaxation bound (node_bound).
+ *   If a candidate without conflicts is excluded, the later candidates dominated by it (mu >=, b >=, obj <=) are excluded too:
+ *   the lexicographically first optimal packing in the branching order satisfies these rules.
+ *   The stack, the conflict counters and the bound arrays are kept in a thread local arena.
+ *   Every node is charged BB_NODE_STEPS steps of the budget.
+*/
+void solve_conic_knap_bb(
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems, /** number of items */
+	const conflict_graph & conflict, /** the conflict graph*/
+	int max_columns, /** the maximal number of packings returned */
+	list<list<int>> & sol_pool, /* solutions pools, solution items are assumed to be sorted */
+	SCIP_Real & sol_val, /** solution value */
+	SCIP_Real & sol_ub, /** solution value upper bound */
+	SOLTYPE_CKNAP & sol_type, /** solution type */
+	work_budget & budget, /** the work budget */
+	SCIP_Real time_limit,  /** solving time left */
+	SCIP_Real target_lb /* the tagret lower bound bound  */
+){
+	auto start = chrono::steady_clock::now();
+	sol_type = Unknown;
+
+	// candidates in the branching order
+	vector<int> & order = arena.order;
+	order.clear();
+	for(int item = 0; item < numitems; item++){
+		if(objs[item] > 0 && mus[item] + Dalpha * sqrt(bs[item]) <= capacity){
+			order.push_back(item);
+		}
+	}
+	SCIP_Real scale = Dalpha * Dalpha / capacity;
+	sort(order.begin(), order.end(), [&](int item1, int item2){
+		return objs[item1] * (mus[item2] + scale * bs[item2]) > objs[item2] * (mus[item1] + scale * bs[item1]);
+	});
+	int numcands = order.size();
+	arena.p_objs.resize(numcands);
+	arena.p_mus.resize(numcands);
+	arena.p_bs.resize(numcands);
+	for(int p = 0; p < numcands; p++){
+		arena.p_objs[p] = objs[order[p]];
+		arena.p_mus[p] = mus[order[p]];
+		arena.p_bs[p] = bs[order[p]];
+	}
+
+	// later candidates dominated by the candidates without conflicts
+	arena.dominated_offsets.assign(numcands + 1, 0);
+	arena.dominated.clear();
+	for(int p = 0; p < numcands; p++){
+		if(conflict.get_diffs(order[p]).size() == 0){
+			for(int q = p + 1; q < numcands; q++){
+				if(arena.p_mus[p] <= arena.p_mus[q] && arena.p_bs[p] <= arena.p_bs[q] && arena.p_objs[p] >= arena.p_objs[q]){
+					arena.dominated.push_back(q);
+				}
+			}
+		}
+		arena.dominated_offsets[p + 1] = arena.dominated.size();
+	}
+
+	arena.blocked.assign(numitems, 0);
+	arena.forced.assign(numcands, 0);
+	arena.path.clear();
+	arena.incumbents.clear();
+	arena.frames.clear();
+	arena.frames.push_back(bb_frame{0, 0, 0, 0, 0});
+
+	// depth first search
+	SCIP_Real threshold = target_lb + tol; // values of the packings to improve
+	SCIP_Real best_val = 0;
+	SCIP_Real root_bound = -1;
+	bool aborted = false;
+	long long nodes = 0;
+	while(!arena.frames.empty()){
+		if(++nodes % BB_CHECK_NODES == 0){
+			budget.charge(BB_CHECK_NODES * BB_NODE_STEPS);
+			if(budget.exhausted(start, time_limit)){
+				aborted = true;
+				break;
+			}
+		}
+		bb_frame & frame = arena.frames.back();
+		int p = frame.pos;
+		if(frame.stage == 0){
+			if(frame.val > threshold){ // improving packing
+				best_val = frame.val;
+				threshold = frame.val;
+				list<int> items_bin(arena.path.begin(), arena.path.end());
+				items_bin.sort();
+				arena.incumbents.push_back(items_bin);
+			}
+			SCIP_Real bound = p < numcands ? node_bound(frame, numcands, Dalpha, capacity, threshold) : frame.val;
+			if(root_bound < 0){
+				root_bound = max(bound, frame.val);
+			}
+			if(p == numcands || bound <= threshold){
+				arena.frames.pop_back();
+				continue;
+			}
+			int item = order[p];
+			bb_frame child{p + 1, 0, frame.summu + arena.p_mus[p], frame.sumb + arena.p_bs[p], frame.val + arena.p_objs[p]};
+			if(arena.blocked[item] == 0 && arena.forced[p] == 0 && child.summu + Dalpha * sqrt(child.sumb) <= capacity){
+				frame.stage = 1;
+				arena.path.push_back(item);
+				for(int item_: conflict.get_diffs(item)){
+					arena.blocked[item_]++;
+				}
+				arena.frames.push_back(child);
+				continue;
+			}
+			frame.stage = 1; // the item is not packed, continue with the exclusion
+			arena.path.push_back(-1);
+		}
+		if(frame.stage == 1){
+			int item = arena.path.back();
+			arena.path.pop_back();
+			if(item != -1){
+				for(int item_: conflict.get_diffs(item)){
+					arena.blocked[item_]--;
+				}
+			}
+			for(int k = arena.dominated_offsets[p]; k < arena.dominated_offsets[p + 1]; k++){
+				arena.forced[arena.dominated[k]]++;
+			}
+			frame.stage = 2;
+			bb_frame child{p + 1, 0, frame.summu, frame.sumb, frame.val};
+			arena.frames.push_back(child);
+		}
+		else{
+			for(int k = arena.dominated_offsets[p]; k < arena.dominated_offsets[p + 1]; k++){
+				arena.forced[arena.dominated[k]]--;
+			}
+			arena.frames.pop_back();
+		}
+	}
+	budget.charge(nodes % BB_CHECK_NODES * BB_NODE_STEPS);
+
+	// the improving packings, best first
+	int num_columns = 0;
+	for(auto it = arena.incumbents.rbegin(); it != arena.incumbents.rend() && num_columns < max_columns; it++, num_columns++){
+		sol_pool.push_back(*it);
+	}
+	if(!arena.incumbents.empty()){
+		sol_val = best_val;
+		sol_ub = aborted ? max(root_bound, best_val) : best_val;
+		sol_type = aborted ? Feasible_Exact : Optimal;
+	}
+	else if(!aborted){
+		sol_val = 0;
+		sol_ub = target_lb + tol;
+		sol_type = Infeasible;
+	}
+	else{
+		sol_type = Aborted;
+	}
+}
+
+
+/** value of the Lagrangian dual function of the continuous SOC relaxation at lambda,
+ *   lambda c + max_{x in [0,1]} p x - a ||sqrt(b) x||, p = obj - lambda mu, a = lambda Dalpha.
+ *   With -a ||y|| = max_{t > 0} -a (||y||^2 / (2t) + t / 2), the inner maximum is max_t G(t), G is concave and separable for a fixed t:
+ *   x_i = min(1, p_i t / (a b_i)), the items are saturated in increasing order of tau_i = a b_i / p_i,
+ *   and G'(t) = 0 at t = a sqrt(Sb / (a^2 - Q)), Sb: b of the saturated items, Q: p^2 / b of the fractional ones.
+*/
+static SCIP_Real soc_dual_value(
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems, /** number of items */
+	SCIP_Real lambda, /** the multiplier of the capacity */
+	vector<pair<SCIP_Real, int>> & taus /** buffer of the saturation points */
+){
+	SCIP_Real a = lambda * Dalpha;
+	SCIP_Real val = lambda * capacity;
+	taus.clear();
+	for(int item = 0; item < numitems; item++){
+		SCIP_Real p = objs[item] - lambda * mus[item];
+		if(p <= 0){
+			continue;
+		}
+		if(a <= 0 || bs[item] <= 0){
+			val += p;
+			continue;
+		}
+		taus.push_back(make_pair(a * bs[item] / p, item));
+	}
+	if(taus.empty()){
+		return val;
+	}
+	sort(taus.begin(), taus.end());
+	int m = taus.size();
+	vector<SCIP_Real> Qs(m + 1, 0); // Qs[k]: Q when the first k items are saturated
+	for(int k = m - 1; k >= 0; k--){
+		int item = taus[k].second;
+		SCIP_Real p = objs[item] - lambda * mus[item];
+		Qs[k] = Qs[k + 1] + p * p / bs[item];
+	}
+	SCIP_Real Sb = 0, Sp = 0, Q = Qs[0], t = 0;
+	for(int k = 0; k <= m; k++){ // the first k items are saturated
+		SCIP_Real lo = k == 0 ? 0 : taus[k - 1].first;
+		SCIP_Real hi = k == m ? INFINITY : taus[k].first;
+		Q = Qs[k];
+		if(a * a > Q){
+			t = a * sqrt(Sb / (a * a - Q));
+			if(t <= hi){
+				t = max(t, lo);
+				break;
+			}
+		}
+		if(k < m){
+			int item = taus[k].second;
+			SCIP_Real p = objs[item] - lambda * mus[item];
+			Sb += bs[item];
+			Sp += p;
+		}
+	}
+	if(t <= 0){ // no item is saturated and x = 0
+		return val;
+	}
+	return val + Sp - a * Sb / (2 * t) + Q * t / (2 * a) - a * t / 2;
+}
+
+
+/** upper bound of the conic knapsack problem, the conflicts are ignored, the minimum of two relaxation bounds:
+ *  - the continuous relaxation of the SOC formulation: max obj x, mu x + Dalpha ||sqrt(b) x|| <= capacity, x in [0, 1].
+ *    Its Lagrangian dual over the capacity multiplier lambda is convex in lambda, it is minimized by a golden section search,
+ *    each evaluation sorts the items once (soc_dual_value), and every evaluated lambda gives a valid bound;
+ *  - the secant relaxation: the packings with positive objectives have b x <= b_hi, the largest b with m(b) + Dalpha sqrt(b) <= capacity,
+ *    m(b) the fractional minimal mu reaching b, then sqrt(b x) >= b x / sqrt(b_hi) and the fractional knapsack bound is taken.
+*/
+SCIP_Real conic_relaxation_bound(
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems /** number of items */
+){
+	// items with positive objectives fitting alone
+	vector<int> cands;
+	SCIP_Real sum_objs = 0;
+	for(int item = 0; item < numitems; item++){
+		if(objs[item] > 0 && mus[item] + Dalpha * sqrt(bs[item]) <= capacity){
+			cands.push_back(item);
+			sum_objs += objs[item];
+		}
+	}
+	if(cands.empty()){
+		return 0;
+	}
+	int m = cands.size();
+	vector<SCIP_Real> c_objs(m), c_mus(m), c_bs(m);
+	for(int i = 0; i < m; i++){
+		c_objs[i] = objs[cands[i]];
+		c_mus[i] = mus[cands[i]];
+		c_bs[i] = bs[cands[i]];
+	}
+
+	// the Lagrangian dual of the continuous SOC relaxation, its value is sum_objs at 0 and at least lambda capacity, so the minimum is in [0, sum_objs / capacity]
+	vector<pair<SCIP_Real, int>> taus;
+	SCIP_Real bound = sum_objs;
+	const SCIP_Real golden = (sqrt(5.0) - 1) / 2;
+	SCIP_Real l = 0, r = sum_objs / capacity;
+	SCIP_Real x1 = r - golden * (r - l), x2 = l + golden * (r - l);
+	SCIP_Real f1 = soc_dual_value(c_objs, c_mus, c_bs, Dalpha, capacity, m, x1, taus);
+	SCIP_Real f2 = soc_dual_value(c_objs, c_mus, c_bs, Dalpha, capacity, m, x2, taus);
+	bound = min(bound, min(f1, f2));
+	for(int iter = 0; iter < 40; iter++){
+		if(f1 <= f2){
+			r = x2;
+			x2 = x1;
+			f2 = f1;
+			x1 = r - golden * (r - l);
+			f1 = soc_dual_value(c_objs, c_mus, c_bs, Dalpha, capacity, m, x1, taus);
+			bound = min(bound, f1);
+		}
+		else{
+			l = x1;
+			x1 = x2;
+			f1 = f2;
+			x2 = l + golden * (r - l);
+			f2 = soc_dual_value(c_objs, c_mus, c_bs, Dalpha, capacity, m, x2, taus);
+			bound = min(bound, f2);
+		}
+	}
+
+	// the largest b of the packings
+	vector<int> order(m);
+	for(int i = 0; i < m; i++){
+		order[i] = i;
+	}
+	sort(order.begin(), order.end(), [&](int i1, int i2){ return c_bs[i1] * c_mus[i2] > c_bs[i2] * c_mus[i1]; });
+	SCIP_Real summu = 0, sumb = 0, b_hi = -1;
+	for(int i: order){
+		if(summu + c_mus[i] + Dalpha * sqrt(sumb + c_bs[i]) <= capacity){
+			summu += c_mus[i];
+			sumb += c_bs[i];
+			continue;
+		}
+		SCIP_Real lo = 0, hi = 1; // fraction of the item
+		for(int iter = 0; iter < 60; iter++){
+			SCIP_Real theta = (lo + hi) / 2;
+			if(summu + theta * c_mus[i] + Dalpha * sqrt(sumb + theta * c_bs[i]) <= capacity){
+				lo = theta;
+			}
+			else{
+				hi = theta;
+			}
+		}
+		b_hi = sumb + hi * c_bs[i];
+		break;
+	}
+	if(b_hi < 0){
+		b_hi = sumb;
+	}
+	b_hi = min(b_hi, capacity * capacity / (Dalpha * Dalpha));
+
+	// the fractional knapsack bound of the secant relaxation
+	vector<pair<SCIP_Real, SCIP_Real>> pieces(m);
+	for(int i = 0; i < m; i++){
+		SCIP_Real weight = c_mus[i] + (b_hi > 0 ? Dalpha * c_bs[i] / sqrt(b_hi) : 0);
+		pieces[i] = make_pair(c_objs[i] / max(weight, 1e-12), weight);
+	}
+	sort(pieces.begin(), pieces.end(), [](const pair<SCIP_Real, SCIP_Real> & piece1, const pair<SCIP_Real, SCIP_Real> & piece2){
+		return piece1.first > piece2.first;
+	});
+	SCIP_Real rem = capacity, secant_bound = 0;
+	for(const pair<SCIP_Real, SCIP_Real> & piece: pieces){
+		if(piece.second <= rem){
+			rem -= piece.second;
+			secant_bound += piece.first * piece.second;
+		}
+		else{
+			secant_bound += piece.first * rem;
+			break;
+		}
+	}
+	return min(bound, secant_bound);
+}
@@ -0,0 +1,41 @@
+/**@file   conic_knapsack_bb.h
+ * @brief  Conic Knapsack combinatorial branch and bound and relaxation bound
+ * @author Liding Xu
+ *---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+#pragma once
+#include <vector>
+#include <list>
+#include "utilities.h"
+using namespace std;
+
+/** solve conic knapsack problem with conflicts by a depth first branch and bound before time_limit,
+ *   either find the optimal solution if its value is greater than the tagret lower bound, or conclude that there is no such solution.
+ *   the improving packings found by the search are returned as well, best first, at most max_columns packings
+*/
+void solve_conic_knap_bb(
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems, /** number of items */
+	const conflict_graph & conflict, /** the conflict graph*/
+	int max_columns, /** the maximal number of packings returned */
+	list<list<int>> & sol_pool, /* solutions pools, solution items are assumed to be sorted */
+	SCIP_Real & sol_val, /** solution value */
+	SCIP_Real & sol_ub, /** solution value upper bound */
+	SOLTYPE_CKNAP & sol_type, /** solution type */
+	work_budget & budget, /** the work budget */
+	SCIP_Real time_limit = 3600,  /** solving time left */
+	SCIP_Real target_lb = 1.0 /* the tagret lower bound bound  */
+);
+
+/** upper bound of the conic knapsack problem from its continuous SOC relaxation and a secant relaxation, the conflicts are ignored */
+SCIP_Real conic_relaxation_bound(
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems /** number of items */
+);
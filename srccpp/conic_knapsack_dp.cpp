@@ -0,0 +1,191 @@
+/**@file   conic_knapsack_dp.cpp
+ * @brief  Conic Knapsack profit scaling dynamic programming
+ * @author Liding Xu
+ *---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+#include <vector>
+#include <list>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include "conic_knapsack_dp.h"
+
+
+/* a state of the dynamic programming, a packing given by the chain of parents */
+struct dp_state{
+	SCIP_Real summu; /** mu of the packed items */
+	SCIP_Real sumb; /** b of the packed items */
+	int parent; /** the state before packing the item, -1 for the empty packing */
+	int item; /** the last packed item */
+};
+
+
+/** insert the state in the Pareto front of (summu, sumb) of a profit level, return false if it is dominated */
+static bool pareto_insert(
+	vector<dp_state> & states, /** all states */
+	vector<int> & front, /** states of the profit level */
+	int state /** the new state */
+){
+	const dp_state & s = states[state];
+	for(int s_: front){
+		if(states[s_].summu <= s.summu && states[s_].sumb <= s.sumb){
+			return false;
+		}
+	}
+	int size = 0;
+	for(int s_: front){ // remove the dominated states
+		if(!(s.summu <= states[s_].summu && s.sumb <= states[s_].sumb)){
+			front[size++] = s_;
+		}
+	}
+	front.resize(size);
+	front.push_back(state);
+	return true;
+}
+
+
+/** solve conic knapsack problem without conflicts by the profit scaling dynamic programming,
+ *   the profits are scaled by K = eps * maxobj / m and rounded down, where m is the number of items with positive objectives fitting alone,
+ *   for each scaled profit level, the dynamic programming keeps the Pareto front of (summu, sumb) of the packings reaching it.
+ *   The packing of the largest feasible level has value at least K * level >= optimal value - eps * maxobj >= (1 - eps) optimal value,
+ *   and K * level + eps * maxobj is an upper bound.
+ *   The items of the packing are completed greedily by the remaining fitting items with positive objectives.
+ *   The states are kept in one array, if their number exceeds DP_MAX_STATES, the solution type is Aborted.
+ *   Every extension of a state by an item is charged one step of the budget, the budget is checked after each item,
+ *   and the solution type is Aborted if it is exhausted.
+*/
+void solve_conic_knap_dp(
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems, /** number of items */
+	SCIP_Real eps, /** the approximation ratio */
+	list<list<int>> & sol_pool, /* solutions pools, solution items are assumed to be sorted */
+	SCIP_Real & sol_val, /** solution value */
+	SCIP_Real & sol_ub, /** solution value upper bound */
+	SOLTYPE_CKNAP & sol_type, /** solution type */
+	work_budget & budget, /** the work budget */
+	SCIP_Real time_limit,  /** solving time left */
+	SCIP_Real target_lb /* the tagret lower bound bound  */
+){
+	auto start = chrono::steady_clock::now();
+	sol_type = Unknown;
+	// items that may be in an optimal packing
+	vector<int> candidates;
+	SCIP_Real max_obj = 0;
+	for(int item = 0; item < numitems; item++){
+		if(objs[item] > 0 && mus[item] + Dalpha * sqrt(bs[item]) <= capacity){
+			candidates.push_back(item);
+			max_obj = max(max_obj, objs[item]);
+		}
+	}
+	if(candidates.empty()){
+		sol_val = 0;
+		sol_ub = 0;
+		sol_type = target_lb - tol > 0 ? Infeasible : Unknown;
+		return;
+	}
+
+	// scale the profits
+	int m = int(candidates.size());
+	SCIP_Real K = eps * max_obj / m;
+	vector<int> profits(m);
+	int num_levels = 1;
+	for(int i = 0; i < m; i++){
+		profits[i] = int(floor(objs[candidates[i]] / K));
+		num_levels += profits[i];
+	}
+
+	// dynamic programming over the profit levels
+	vector<dp_state> states;
+	states.reserve(min(DP_MAX_STATES, 16 * num_levels));
+	vector<vector<int>> fronts(num_levels);
+	states.push_back(dp_state{0, 0, -1, -1});
+	fronts[0].push_back(0);
+	int max_level = 0;
+	for(int i = 0; i < m; i++){
+		if(profits[i] == 0){ // only packed by the completion
+			continue;
+		}
+		if(budget.exhausted(start, time_limit)){
+			sol_type = Aborted;
+			return;
+		}
+		int item = candidates[i];
+		long long num_steps = 0;
+		for(int level = max_level; level >= 0; level--){
+			num_steps += fronts[level].size();
+			for(int state: fronts[level]){ // profits[i] > 0, so this front does not change while it is extended
+				SCIP_Real summu = states[state].summu + mus[item];
+				SCIP_Real sumb = states[state].sumb + bs[item];
+				if(summu + Dalpha * sqrt(sumb) > capacity){
+					continue;
+				}
+				if(int(states.size()) >= DP_MAX_STATES){
+					budget.charge(num_steps);
+					sol_type = Aborted;
+					return;
+				}
+				states.push_back(dp_state{summu, sumb, state, item});
+				if(pareto_insert(states, fronts[level + profits[i]], int(states.size()) - 1)){
+					max_level = max(max_level, level + profits[i]);
+				}
+				else{
+					states.pop_back();
+				}
+			}
+		}
+		budget.charge(num_steps);
+	}
+
+	// the packing of the largest level with the largest value
+	int best_state = -1;
+	SCIP_Real best_val = -1;
+	for(int state: fronts[max_level]){
+		SCIP_Real val = 0;
+		for(int s = state; states[s].parent != -1; s = states[s].parent){
+			val += objs[states[s].item];
+		}
+		if(val > best_val){
+			best_val = val;
+			best_state = state;
+		}
+	}
+	vector<bool> packed(numitems, false);
+	for(int s = best_state; states[s].parent != -1; s = states[s].parent){
+		packed[states[s].item] = true;
+	}
+	SCIP_Real summu = states[best_state].summu, sumb = states[best_state].sumb;
+	vector<int> completion;
+	for(int item: candidates){
+		if(!packed[item]){
+			completion.push_back(item);
+		}
+	}
+	sort(completion.begin(), completion.end(), [&objs](int item1, int item2){ return objs[item1] > objs[item2]; });
+	for(int item: completion){
+		if(summu + mus[item] + Dalpha * sqrt(sumb + bs[item]) <= capacity){
+			summu += mus[item];
+			sumb += bs[item];
+			best_val += objs[item];
+			packed[item] = true;
+		}
+	}
+
+	sol_val = best_val;
+	sol_ub = max(best_val, K * max_level + eps * max_obj);
+	if(sol_val > target_lb + tol){
+		list<int> items_bin;
+		for(int item = 0; item < numitems; item++){
+			if(packed[item]){
+				items_bin.push_back(item);
+			}
+		}
+		sol_pool.push_back(items_bin);
+		sol_type = sol_ub - sol_val <= tol ? Optimal : Feasible_Exact;
+	}
+	else if(sol_ub < target_lb - tol){
+		sol_type = Infeasible;
+	}
+}
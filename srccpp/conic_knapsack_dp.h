@@ -0,0 +1,31 @@
+/**@file   conic_knapsack_dp.h
+ * @brief  Conic Knapsack profit scaling dynamic programming
+ * @author Liding Xu
+ *---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+#pragma once
+#include <vector>
+#include <list>
+#include "utilities.h"
+using namespace std;
+
+#define DP_MAX_STATES 4194304 /* maximal number of states of the dynamic programming */
+
+/** solve conic knapsack problem without conflicts by the profit scaling dynamic programming before time_limit or the work limit of the budget,
+ *   the solution value is at least (1 - eps) times the optimal value, and sol_ub is a valid upper bound
+*/
+void solve_conic_knap_dp(
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems, /** number of items */
+	SCIP_Real eps, /** the approximation ratio */
+	list<list<int>> & sol_pool, /* solutions pools, solution items are assumed to be sorted */
+	SCIP_Real & sol_val, /** solution value */
+	SCIP_Real & sol_ub, /** solution value upper bound */
+	SOLTYPE_CKNAP & sol_type, /** solution type */
+	work_budget & budget, /** the work budget */
+	SCIP_Real time_limit = 3600,  /** solving time left */
+	SCIP_Real target_lb = 1.0 /* the tagret lower bound bound  */
+);
@@ -6,12 +6,163 @@
 #include <vector>
 #include <list>
 #include <limits>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <random>
 #include <ilcplex/ilocplex.h>
 #include "conic_knapsack_heur.h"
+#include "conic_knapsack_kernel.h"
+
+
+/** the item order shared by all starts of the best fit heuristic,
+ *   items are sorted by a decreasing upper bound on their best fit ratio and stored as aligned structure of arrays,
+ *   padded to the kernel width with ineligible items, the conflict graph is relabeled by the sorted positions.
+ *   The ratio of an item is objs / (mu + Dalpha * (sqrt(sumb + b) - sqrt(sumb))), it is bounded by
+ *   objs / mu if objs >= 0 and by objs / (mu + Dalpha * sqrt(b)) otherwise, for any packed sumb.
+*/
+struct best_fit_order{
+	int padded; /** number of padded positions */
+	aligned_reals mus, bs, objs; /** mus, bs, objs in the sorted order */
+	vector<SCIP_Real> ratio_ub; /** upper bounds of ratios in the sorted order, nonincreasing */
+	vector<int> items; /** original items in the sorted order */
+	vector<int> pos; /** positions of the original items in the sorted order */
+	conflict_graph conflict; /** the conflict graph over the sorted positions */
+
+	best_fit_order(
+		const vector<SCIP_Real> & objs_, /** objective coefficients of items */
+		const vector<SCIP_Real> & mus_, /** mu of items */
+		const vector<SCIP_Real> & bs_, /** b of items */
+		SCIP_Real Dalpha, /** Dalpha */
+		SCIP_Real capacity, /** capacity */
+		int numitems, /** number of items */
+		const conflict_graph & conflict_ /** the conflict graph*/
+	): padded(kernel_padded_size(numitems)), items(numitems), pos(numitems){
+		mus = aligned_reals(padded, 0);
+		bs = aligned_reals(padded, 0);
+		objs = aligned_reals(padded, 0);
+		ratio_ub = vector<SCIP_Real>(padded, -numeric_limits<SCIP_Real>::infinity());
+		// slack absorbs the rounding of lhs_ - lhs, whose terms are bounded by the capacity
+		SCIP_Real slack = 1e-12 * capacity;
+		vector<SCIP_Real> ub(numitems);
+		for(int item = 0; item < numitems; item++){
+			if(objs_[item] > 0){
+				ub[item] = mus_[item] > slack ? objs_[item] / (mus_[item] - slack) : numeric_limits<SCIP_Real>::infinity();
+			}
+			else if(objs_[item] < 0){
+				ub[item] = objs_[item] / (mus_[item] + Dalpha * sqrt(bs_[item]) + slack);
+			}
+			else{
+				ub[item] = 0;
+			}
+			items[item] = item;
+		}
+		stable_sort(items.begin(), items.end(), [&ub](int item1, int item2){ return ub[item1] > ub[item2]; });
+		for(int p = 0; p < numitems; p++){
+			int item = items[p];
+			mus[p] = mus_[item];
+			bs[p] = bs_[item];
+			objs[p] = objs_[item];
+			ratio_ub[p] = ub[item];
+			pos[item] = p;
+		}
+		conflict = conflict_graph(conflict_, items, pos);
+	}
+};
+
+
+/** run the best fit greedy that forces the item fix in the solution,
+ *   the positions of the packed items are stored in packed, return false if the start is not packable.
+ *   The candidates are kept in a bitset over the sorted positions and are evaluated block by block by the kernel.
+*/
+static bool best_fit_start(
+	const best_fit_order & order, /** the shared item order */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems, /** number of items */
+	int fix, /** the item forced in the solution */
+	vector<uint64_t> & eligible, /** scratch bitset of the unknown items, indexed by sorted positions */
+	vector<int> & packed, /** positions of the packed items */
+	SCIP_Real & obj /** solution value */
+){
+	alignas(KERNEL_ALIGN) SCIP_Real cap_use[KERNEL_WIDTH];
+	alignas(KERNEL_ALIGN) SCIP_Real ratios[KERNEL_WIDTH];
+	int numwords = int(eligible.size());
+	fill(eligible.begin(), eligible.end(), 0);
+	for(int p = 0; p < numitems; p++){
+		eligible[p / 64] |= uint64_t(1) << (p % 64);
+	}
+	int fix_pos = order.pos[fix];
+	SCIP_Real sumb = order.bs[fix_pos];
+	SCIP_Real summu = order.mus[fix_pos];
+	obj = order.objs[fix_pos];
+	packed.clear();
+	packed.push_back(fix_pos); // add to the solution
+	eligible[fix_pos / 64] &= ~(uint64_t(1) << (fix_pos % 64));
+	SCIP_Real lhs = summu +  Dalpha * sqrt(sumb); 
+	if(lhs > capacity){ // if not packable cont.
+		return false;
+	}
+	order.conflict.clear_diffs(fix_pos, eligible); // fixed by conflict
+	int head = 0; // words before head are decided
+	while(true){
+		SCIP_Real best_ratio  = -1;
+		int candidate = -1;
+		while(head < numwords && eligible[head] == 0){
+			head++;
+		}
+		if(head == numwords){
+			break;
+		}
+		int first = head * 64 + (__builtin_ctzll(eligible[head]) / KERNEL_WIDTH) * KERNEL_WIDTH;
+		for(int p0 = first; p0 < order.padded; p0 += KERNEL_WIDTH){
+			if(order.ratio_ub[p0] < best_ratio){ // no remaining item beats the best ratio
+				break;
+			}
+			unsigned block = kernel_block_bits(eligible, p0);
+			if(block == 0){
+				continue;
+			}
+			unsigned fit = conic_kernel(&order.mus[p0], &order.bs[p0], &order.objs[p0], block, summu, sumb, lhs, Dalpha, capacity, cap_use, ratios);
+			kernel_clear_block_bits(eligible, p0, block & ~fit); // not packable anymore
+			for(; fit != 0; fit &= fit - 1){
+				int lane = __builtin_ctz(fit);
+				SCIP_Real ratio = ratios[lane];
+				if(ratio > best_ratio || (ratio == best_ratio && candidate != -1 && order.items[p0 + lane] < order.items[candidate])){
+					best_ratio = ratio;
+					candidate = p0 + lane;
+				}
+			}
+		}
+		if(candidate != -1){
+			summu += order.mus[candidate];
+			sumb += order.bs[candidate];
+			obj += order.objs[candidate];
+			lhs = summu + Dalpha * sqrt(sumb);
+			order.conflict.clear_diffs(candidate, eligible); // fixed by conflict
+			eligible[candidate / 64] &= ~(uint64_t(1) << (candidate % 64));
+			packed.push_back(candidate);
+		}
+		else{
+			break;
+		}
+	}
+	return true;
+}
 
 
 /** find a feasible solution for conic knapsack problem by the best fit heuristic,
  *   each time, the method forces one of the items to be in the solution and storing the best solution found.
+ *   The candidate scan visits items by decreasing ratio bound and stops once no remaining item can beat the best ratio,
+ *   ties are broken by the smallest item, so the packing is the one of the plain rescan of all items.
+ *   With several threads, the starts are handed out in chunks to the threads, each thread has its own scratch buffers,
+ *   and the best solutions of the threads are reduced with the same tie breaking (smallest start) as the sequential loop.
+ *   Dominated items are not tried as starts, they are queried from the dominance index built with the merged items.
+ *   No chunk of starts is handed out after time_limit seconds from start. A start is charged numitems steps of the budget,
+ *   and with a deterministic budget the starts handed out are the ones of the chunks beginning before the tried starts left in the budget,
+ *   so the packings do not depend on the number of threads.
+ *   The packings of the other starts with value greater than min_val are also kept, sorted by decreasing value (smallest start first).
 */
 void solve_conic_knap_best_fit(
 	const vector<SCIP_Real> & objs, /** objective coefficients of items */
@@ -21,91 +172,425 @@ void solve_conic_knap_best_fit(
 	SCIP_Real capacity, /** capacity */
 	int numitems, /** number of items */
 	const conflict_graph & conflict, /** the conflict graph*/
+	const dominance_index & dominance, /** the dominance index of the items */
+	int num_threads, /** number of threads */
+	work_budget & budget, /** the work budget */
+	chrono::steady_clock::time_point start, /** the start time of the heuristics */
+	SCIP_Real time_limit, /** solving time left after start */
+	SCIP_Real min_val, /** the minimal value of the other packings kept */
     vector<int> & items_bin, /* items in the maximal bin, assumed to be sorted */
+	SCIP_Real & sol_val, /** solution value */
+	vector<pair<SCIP_Real, vector<int>>> & packings /** other packings with value greater than min_val, items are sorted */
+){
+	best_fit_order order(objs, mus, bs, Dalpha, capacity, numitems, conflict);
+	vector<bool> never_try; // dominated items are not tried as starts
+	dominance.query(objs, never_try);
+
+	const int chunk = 16; // starts handed out at once
+	num_threads = max(1, min(num_threads, (numitems + chunk - 1) / chunk));
+	vector<SCIP_Real> best_sol_vals(num_threads, -1);
+	vector<int> best_fixes(num_threads, -1);
+	vector<vector<int>> best_sols(num_threads);
+	vector<vector<pair<pair<SCIP_Real, int>, vector<int>>>> other_sols(num_threads); // (value, start) and items of the other packings
+	atomic<int> next_fix(0);
+	int max_fix = numitems; // starts handed out before max_fix
+	if(budget.is_det()){ // the tried starts left in the budget
+		SCIP_Real starts_left = ceil(max(budget.left(), 0.0) * WORK_UNIT_STEPS / numitems);
+		max_fix = 0;
+		for(int tried = 0; max_fix < numitems && tried < starts_left; max_fix++){
+			if(objs[max_fix] >= tol && !never_try[max_fix]){
+				tried++;
+			}
+		}
+	}
+	auto run_starts = [&](int thread_id){
+		vector<uint64_t> eligible((order.padded + 63) / 64); // per thread scratch buffers
+		vector<int> packed;
+		SCIP_Real & best_sol_val = best_sol_vals[thread_id];
+		long long num_starts = 0;
+		while(true){
+			if(budget.is_det() ? budget.is_cancelled() : budget.exhausted(start, time_limit)){
+				break;
+			}
+			int first = next_fix.fetch_add(chunk);
+			if(first >= max_fix){
+				break;
+			}
+			int last = min(first + chunk, numitems);
+			for(int fix = first; fix < last; fix++){
+				SCIP_Real obj;
+				if(objs[fix] < tol || never_try[fix]){
+					continue;
+				}
+				num_starts++;
+				if(!best_fit_start(order, Dalpha, capacity, numitems, fix, eligible, packed, obj)){
+					continue;
+				}
+				if(obj > min_val){
+					other_sols[thread_id].push_back(make_pair(make_pair(obj, fix), vector<int>()));
+					for(int p: packed){
+						other_sols[thread_id].back().second.push_back(order.items[p]);
+					}
+				}
+				// an improving solution found, update
+				if(obj > best_sol_val || (obj == best_sol_val && fix < best_fixes[thread_id])){
+					best_sol_val = obj;
+					best_fixes[thread_id] = fix;
+					best_sols[thread_id].clear();
+					for(int p: packed){
+						best_sols[thread_id].push_back(order.items[p]);
+					}
+				}
+			}
+		}
+		budget.charge(num_starts * numitems);
+	};
+	if(num_threads == 1){
+		run_starts(0);
+	}
+	else{
+		vector<thread> workers;
+		for(int thread_id = 1; thread_id < num_threads; thread_id++){
+			workers.emplace_back(run_starts, thread_id);
+		}
+		run_starts(0);
+		for(auto & worker: workers){
+			worker.join();
+		}
+	}
+
+	// reduce the solutions of the threads
+	int best_thread = 0;
+	for(int thread_id = 1; thread_id < num_threads; thread_id++){
+		if(best_sol_vals[thread_id] > best_sol_vals[best_thread] || (best_sol_vals[thread_id] == best_sol_vals[best_thread] && best_fixes[thread_id] != -1 
+			&& (best_fixes[best_thread] == -1 || best_fixes[thread_id] < best_fixes[best_thread]))){
+			best_thread = thread_id;
+		}
+	}
+	sol_val = best_sol_vals[best_thread];
+	items_bin = best_sols[best_thread];
+	sort(items_bin.begin(), items_bin.end());
+
+	// merge the other packings of the threads, except the best one
+	vector<pair<pair<SCIP_Real, int>, vector<int>>> others;
+	for(int thread_id = 0; thread_id < num_threads; thread_id++){
+		for(auto & sol: other_sols[thread_id]){
+			if(sol.first.second != best_fixes[best_thread]){
+				others.push_back(move(sol));
+			}
+		}
+	}
+	sort(others.begin(), others.end(), [](const pair<pair<SCIP_Real, int>, vector<int>> & sol1, const pair<pair<SCIP_Real, int>, vector<int>> & sol2){
+		return sol1.first.first > sol2.first.first || (sol1.first.first == sol2.first.first && sol1.first.second < sol2.first.second);
+	});
+	packings.clear();
+	for(auto & sol: others){
+		sort(sol.second.begin(), sol.second.end());
+		packings.push_back(make_pair(sol.first.first, move(sol.second)));
+	}
+};
+
+
+/** Jaccard similarity of two sorted packings */
+static SCIP_Real jaccard_similarity(
+	const vector<int> & items1, /** sorted items of the first packing */
+	const vector<int> & items2 /** sorted items of the second packing */
+){
+	int common = 0;
+	for(auto it1 = items1.begin(), it2 = items2.begin(); it1 != items1.end() && it2 != items2.end();){
+		if(*it1 < *it2){
+			it1++;
+		}
+		else if(*it2 < *it1){
+			it2++;
+		}
+		else{
+			common++;
+			it1++;
+			it2++;
+		}
+	}
+	int unions = int(items1.size() + items2.size()) - common;
+	return unions > 0 ? SCIP_Real(common) / unions : 1;
+}
+
+
+/** improve a feasible solution of the conic knapsack problem by local search,
+ *   the moves are 1-drop (an item with a negative obj), 1-add, 1-1 swap (one packed item replaced by one item)
+ *   and 2-1 swap (two packed items replaced by one item), the best improving move of the first improving neighborhood is applied
+ *   until no move improves the solution by more than tol.
+ *   summu, sumb and the number of packed items in conflict with each item are updated incrementally.
+*/
+static void local_search(
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems, /** number of items */
+	const conflict_graph & conflict, /** the conflict graph*/
+    vector<int> & items_bin, /* items in the bin, sorted */
 	SCIP_Real & sol_val /** solution value */
 ){
-	vector<short> status(numitems); // -1 unknown, 0 inpacked, 1 packed
-	SCIP_Real best_sol_val  = -1;
-	list<int> best_sol;
-	vector<bool>never_try(numitems, false);
-	int num_never_try = 0;
-	for(int item1 = 0; item1 < numitems; item1++){
-			SCIP_Real mu1 = mus[item1];
-			SCIP_Real b1 = bs[item1];
-			SCIP_Real obj1 = objs[item1];
-			for(int item2 = item1 + 1; item2 < numitems; item2++){
-				if(mu1 >= mus[item2] && b1 >= bs[item2] && obj1<= objs[item2]){
-					never_try[item1] = true;
-					num_never_try++;
+	vector<bool> in_bin(numitems, false);
+	vector<int> num_conflicts(numitems, 0); // number of packed items in conflict with the item
+	SCIP_Real summu = 0, sumb = 0;
+	auto apply_move = [&](int item, bool pack){
+		int sign = pack ? 1 : -1;
+		in_bin[item] = pack;
+		summu += sign * mus[item];
+		sumb += sign * bs[item];
+		sol_val += sign * objs[item];
+		for(int item_: conflict.get_diffs(item)){
+			num_conflicts[item_] += sign;
+		}
+	};
+	// fits the capacity after the increases of mu and b
+	auto fits = [&](SCIP_Real mu, SCIP_Real b){
+		return summu + mu + Dalpha * sqrt(max(sumb + b, 0.0)) <= capacity;
+	};
+	// the first packed item in conflict with the item, -1 if none
+	auto conflicting = [&](int item){
+		for(int item_: conflict.get_diffs(item)){
+			if(in_bin[item_]){
+				return item_;
+			}
+		}
+		return -1;
+	};
+	sol_val = 0;
+	for(int item: items_bin){
+		apply_move(item, true);
+	}
+
+	vector<int> packed;
+	while(true){
+		packed.clear();
+		for(int item = 0; item < numitems; item++){
+			if(in_bin[item]){
+				packed.push_back(item);
+			}
+		}
+		// 1-drop
+		bool dropped = false;
+		for(int item: packed){
+			if(objs[item] < -tol){
+				apply_move(item, false);
+				dropped = true;
+			}
+		}
+		if(dropped){
+			continue;
+		}
+
+		// 1-add
+		int add = -1;
+		for(int item = 0; item < numitems; item++){
+			if(!in_bin[item] && num_conflicts[item] == 0 && objs[item] > tol && (add == -1 || objs[item] > objs[add]) && fits(mus[item], bs[item])){
+				add = item;
+			}
+		}
+		if(add != -1){
+			apply_move(add, true);
+			continue;
+		}
+
+		// 1-1 and 2-1 swaps, the packed items are visited by increasing obj to prune the swaps
+		if(packed.empty()){
+			break;
+		}
+		sort(packed.begin(), packed.end(), [&objs](int item1, int item2){ return objs[item1] < objs[item2]; });
+		int swap_in = -1, swap_out = -1, swap_out2 = -1;
+		SCIP_Real best_gain = tol;
+		for(int item = 0; item < numitems; item++){
+			if(in_bin[item] || num_conflicts[item] > 1 || objs[item] - objs[packed[0]] <= best_gain){
+				continue;
+			}
+			int only = num_conflicts[item] == 1 ? conflicting(item) : -1;
+			for(int i1 = 0; i1 < int(packed.size()) && objs[item] - objs[packed[i1]] > best_gain; i1++){
+				int out1 = packed[i1];
+				if((only == -1 || out1 == only) && fits(mus[item] - mus[out1], bs[item] - bs[out1])){
+					best_gain = objs[item] - objs[out1];
+					swap_in = item;
+					swap_out = out1;
 					break;
 				}
-		}	
-	}
-	for(int fix = 0; fix < numitems; fix++){
-		fill(status.begin(), status.end(), -1);
-		SCIP_Real sumb = bs[fix];
-		SCIP_Real summu = mus[fix];
-		SCIP_Real obj = objs[fix];
-		if(objs[fix] < tol || never_try[fix]){
-			continue;
+			}
 		}
-		status[fix] = 1; // add to the solution
-		SCIP_Real lhs = summu +  Dalpha * sqrt(sumb); 
-		if(lhs > capacity){ // if not packable cont.
+		if(swap_in != -1){
+			apply_move(swap_out, false);
+			apply_move(swap_in, true);
 			continue;
 		}
-		for(int item: conflict.get_diffs(fix)){ // fixed by conflict
-			status[item] = 0;
+		// the two largest mu and b of the packed items bound the capacity freed by any pair
+		SCIP_Real max_mus[2] = {0, 0}, max_bs[2] = {0, 0};
+		for(int item_: packed){
+			if(mus[item_] > max_mus[0]){
+				max_mus[1] = max_mus[0];
+				max_mus[0] = mus[item_];
+			}
+			else if(mus[item_] > max_mus[1]){
+				max_mus[1] = mus[item_];
+			}
+			if(bs[item_] > max_bs[0]){
+				max_bs[1] = max_bs[0];
+				max_bs[0] = bs[item_];
+			}
+			else if(bs[item_] > max_bs[1]){
+				max_bs[1] = bs[item_];
+			}
 		}
-		while(true){
-			SCIP_Real best_ratio  = -1;
-			int candidate = -1;
-			for(int item = 0; item < numitems; item++){
-				if( status[item] != -1){
-					continue;
+		for(int item = 0; item < numitems; item++){
+			if(in_bin[item] || num_conflicts[item] > 2 || packed.size() < 2 || objs[item] - objs[packed[0]] - objs[packed[1]] <= best_gain){
+				continue;
+			}
+			if(!fits(mus[item] - max_mus[0] - max_mus[1], bs[item] - max_bs[0] - max_bs[1])){
+				continue;
+			}
+			int conflict1 = -1, conflict2 = -1; // the packed items in conflict with the item, both must be swapped out
+			for(int item_: conflict.get_diffs(item)){
+				if(in_bin[item_]){
+					(conflict1 == -1 ? conflict1 : conflict2) = item_;
 				}
-				SCIP_Real lhs_ = summu + mus[item] + Dalpha * sqrt(sumb + bs[item]);
-				if(lhs_ > capacity){
-					status[item] = 0;
+			}
+			for(int i1 = 0; i1 + 1 < int(packed.size()) && objs[item] - objs[packed[i1]] - objs[packed[i1 + 1]] > best_gain; i1++){
+				if(!fits(mus[item] - mus[packed[i1]] - max_mus[0], bs[item] - bs[packed[i1]] - max_bs[0])){
 					continue;
 				}
-				SCIP_Real ratio =  objs[item] / (lhs_ - lhs);
-				if(ratio > best_ratio){
-					best_ratio = ratio;
-					candidate = item;
+				for(int i2 = i1 + 1; i2 < int(packed.size()) && objs[item] - objs[packed[i1]] - objs[packed[i2]] > best_gain; i2++){
+					int out1 = packed[i1], out2 = packed[i2];
+					if(conflict1 != -1 && conflict1 != out1 && conflict1 != out2){
+						continue;
+					}
+					if(conflict2 != -1 && conflict2 != out1 && conflict2 != out2){
+						continue;
+					}
+					if(fits(mus[item] - mus[out1] - mus[out2], bs[item] - bs[out1] - bs[out2])){
+						best_gain = objs[item] - objs[out1] - objs[out2];
+						swap_in = item;
+						swap_out = out1;
+						swap_out2 = out2;
+						break;
+					}
 				}
 			}
-			if(candidate != -1){
-				summu += mus[candidate];
-				sumb += bs[candidate];
-				obj += objs[candidate];
-				lhs = summu + Dalpha * sqrt(sumb);
-				for(int item_: conflict.get_diffs(candidate)){ // fixed by conflict
-					status[item_] = 0;
+		}
+		if(swap_in != -1){
+			apply_move(swap_out, false);
+			apply_move(swap_out2, false);
+			apply_move(swap_in, true);
+			continue;
+		}
+		break;
+	}
+
+	items_bin.clear();
+	for(int item = 0; item < numitems; item++){
+		if(in_bin[item]){
+			items_bin.push_back(item);
+		}
+	}
+}
+
+
+/** find a feasible solution for conic knapsack problem by the GRASP heuristic until the budget is exhausted or for grasp_iters iterations,
+ *   each iteration packs items by a randomized greedy: the next item is drawn uniformly from the restricted candidate list
+ *   of the fitting items with ratio >= best_ratio - grasp_alpha * (best_ratio - worst_ratio), then the packing is improved by local search.
+ *   It stops once the best packing has value greater than target_lb, the best packing found so far is returned.
+ *   The random generator is seeded by grasp_seed, so the heuristic is deterministic up to the time limit, a kernel block is charged KERNEL_WIDTH steps and a local search numitems steps.
+*/
+static void solve_conic_knap_grasp(
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems, /** number of items */
+	const conflict_graph & conflict, /** the conflict graph*/
+	const conf & algo_conf, /** algorithm configuration*/
+	work_budget & budget, /** the work budget */
+	chrono::steady_clock::time_point start, /** the start time of the heuristics */
+	SCIP_Real time_limit, /** solving time left after start */
+	SCIP_Real target_lb, /* the tagret lower bound bound  */
+    vector<int> & items_bin, /* items in the best bin, sorted */
+	SCIP_Real & sol_val /** solution value */
+){
+	alignas(KERNEL_ALIGN) SCIP_Real cap_use[KERNEL_WIDTH];
+	alignas(KERNEL_ALIGN) SCIP_Real ratios[KERNEL_WIDTH];
+	best_fit_order order(objs, mus, bs, Dalpha, capacity, numitems, conflict);
+	mt19937 rng(algo_conf.grasp_seed);
+	vector<uint64_t> eligible((order.padded + 63) / 64);
+	vector<pair<int, SCIP_Real>> fitting; // positions and ratios of the fitting items
+	vector<int> candidates; // restricted candidate list
+	vector<int> packing;
+	for(int iter = 0; iter < algo_conf.grasp_iters && sol_val <= target_lb + tol && !budget.exhausted(start, time_limit); iter++){
+		fill(eligible.begin(), eligible.end(), 0);
+		for(int p = 0; p < numitems; p++){
+			if(order.objs[p] > 0){
+				eligible[p / 64] |= uint64_t(1) << (p % 64);
+			}
+		}
+		SCIP_Real summu = 0, sumb = 0, lhs = 0, obj = 0;
+		packing.clear();
+		while(true){
+			fitting.clear();
+			SCIP_Real best_ratio = -numeric_limits<SCIP_Real>::infinity(), worst_ratio = numeric_limits<SCIP_Real>::infinity();
+			for(int p0 = 0; p0 < order.padded; p0 += KERNEL_WIDTH){
+				unsigned block = kernel_block_bits(eligible, p0);
+				if(block == 0){
+					continue;
+				}
+				unsigned fit = conic_kernel(&order.mus[p0], &order.bs[p0], &order.objs[p0], block, summu, sumb, lhs, Dalpha, capacity, cap_use, ratios);
+				budget.charge(KERNEL_WIDTH);
+				kernel_clear_block_bits(eligible, p0, block & ~fit); // not packable anymore
+				for(; fit != 0; fit &= fit - 1){
+					int lane = __builtin_ctz(fit);
+					fitting.push_back(make_pair(p0 + lane, ratios[lane]));
+					best_ratio = max(best_ratio, ratios[lane]);
+					worst_ratio = min(worst_ratio, ratios[lane]);
 				}
-				status[candidate] = 1;
 			}
-			else{
+			if(fitting.empty()){
 				break;
 			}
-		}
-		// an improving solution found, update
-		if(obj > best_sol_val){
-			best_sol_val = obj;
-			best_sol.clear();
-			for(int item = 0; item < numitems; item++){
-				if(status[item] == 1){
-					best_sol.push_back(item);
+			SCIP_Real threshold = best_ratio - algo_conf.grasp_alpha * (best_ratio - worst_ratio);
+			candidates.clear();
+			for(auto & item_ratio: fitting){
+				if(item_ratio.second >= threshold){
+					candidates.push_back(item_ratio.first);
 				}
 			}
+			int candidate = candidates[uniform_int_distribution<int>(0, int(candidates.size()) - 1)(rng)];
+			summu += order.mus[candidate];
+			sumb += order.bs[candidate];
+			obj += order.objs[candidate];
+			lhs = summu + Dalpha * sqrt(sumb);
+			order.conflict.clear_diffs(candidate, eligible); // fixed by conflict
+			eligible[candidate / 64] &= ~(uint64_t(1) << (candidate % 64));
+			packing.push_back(order.items[candidate]);
+		}
+		if(packing.empty()){
+			break;
+		}
+		sort(packing.begin(), packing.end());
+		if(algo_conf.is_local_search){
+			local_search(objs, mus, bs, Dalpha, capacity, numitems, conflict, packing, obj);
+			budget.charge(numitems);
+		}
+		if(obj > sol_val){
+			sol_val = obj;
+			items_bin = packing;
 		}
 	}
-	sol_val = best_sol_val;
-	items_bin = vector<int>(best_sol.begin(), best_sol.end());
-};
+}
 
 
-/** find a feasible solution for conic knapsack problem by heuristics, 
+/** find feasible solutions for conic knapsack problem by heuristics, 
+ *   up to heur_columns packings are returned: the best one, then the packings of the other starts in decreasing value
+ *   whose Jaccard similarity with every selected packing is at most heur_jaccard.
+ *   The packings of the last pricing rounds are repaired and improved by the local search under the new objectives,
+ *   and compete with the best fit packings for the selection.
+ *   If the best fit packings do not reach target_lb, the GRASP heuristic runs until the budget is exhausted.
  * Notice: the heuristics only applies for the merged items.
 */
 void solve_conic_knap_heur(
@@ -115,23 +600,92 @@ void solve_conic_knap_heur(
 	SCIP_Real Dalpha, /** Dalpha */
 	SCIP_Real capacity, /** capacity */
 	int numitems, /** number of items */
-	const vector<pair<int,int>>& items_diff, /** items in same constraints */
 	const conflict_graph & conflict, /** the conflict graph*/
-	vector<int> & items_bin, /* items in the maximal bin, assumed to be sorted */
+	const dominance_index & dominance, /** the dominance index of the items */
+	const list<vector<int>> & warm_starts, /** packings of the last pricing rounds, sorted items */
+	const conf & algo_conf, /** algorithm configuration*/
+	list<list<int>> & sol_pool, /* solutions pools with values greater than target_lb, the best first, solution items are sorted */
 	SCIP_Real & sol_val, /** solution value */
+	work_budget & budget, /** the work budget */
 	SCIP_Real time_limit ,  /** solving time left */
 	SCIP_Real target_lb /* the tagret lower bound bound  */
 ){
+   auto start = chrono::steady_clock::now();
    vector<int> items_bin_best_fit; /* items in the maximal bin, assumed to be sorted */
    SCIP_Real  sol_val_best_fit = 0; /** solution value */
+   vector<pair<SCIP_Real, vector<int>>> packings; /* other packings of the best fit heuristic */
     //SCIPdebugMessage("enter heur,%lf\n", time_limit);
     solve_conic_knap_best_fit(objs, mus, bs, Dalpha, capacity,
-    numitems, conflict, items_bin_best_fit, sol_val_best_fit);
-	//SCIPdebugMessage("quit heur,%lf\n", sol_val_best_fit);
-	if(sol_val_best_fit > target_lb +tol ){
-		sol_val = sol_val_best_fit;
-		items_bin = items_bin_best_fit;
-		//printf("best_f\n");
-	}
-	
-};
\ No newline at end of file
+    numitems, conflict, dominance, algo_conf.heur_threads, budget, start, time_limit, algo_conf.heur_columns > 1 ? target_lb + tol : numeric_limits<SCIP_Real>::infinity(), 
+	items_bin_best_fit, sol_val_best_fit, packings);
+
+	// select the diverse packings, there are none if the budget ran out before the first start of the best fit
+	vector<pair<SCIP_Real, vector<int>>> columns;
+	if(!items_bin_best_fit.empty()){
+		columns.push_back(make_pair(sol_val_best_fit, items_bin_best_fit));
+	}
+	for(auto & packing: packings){
+		if(int(columns.size()) >= algo_conf.heur_columns){
+			break;
+		}
+		bool is_diverse = true;
+		for(auto & column: columns){
+			if(jaccard_similarity(packing.second, column.second) > algo_conf.heur_jaccard){
+				is_diverse = false;
+				break;
+			}
+		}
+		if(is_diverse){
+			columns.push_back(move(packing));
+		}
+	}
+	if(algo_conf.is_local_search){
+		for(auto & column: columns){
+			local_search(objs, mus, bs, Dalpha, capacity, numitems, conflict, column.second, column.first);
+		}
+		stable_sort(columns.begin(), columns.end(), [](const pair<SCIP_Real, vector<int>> & column1, const pair<SCIP_Real, vector<int>> & column2){
+			return column1.first > column2.first;
+		});
+	}
+	if(!warm_starts.empty()){
+		// the local search drops the items with negative objectives, so the packings are feasible again
+		for(auto & warm_start: warm_starts){
+			columns.push_back(make_pair(0, warm_start));
+			local_search(objs, mus, bs, Dalpha, capacity, numitems, conflict, columns.back().second, columns.back().first);
+		}
+		stable_sort(columns.begin(), columns.end(), [](const pair<SCIP_Real, vector<int>> & column1, const pair<SCIP_Real, vector<int>> & column2){
+			return column1.first > column2.first;
+		});
+		// select again the diverse packings
+		int size = 1;
+		for(int i = 1; i < int(columns.size()) && size < algo_conf.heur_columns; i++){
+			bool is_diverse = true;
+			for(int j = 0; j < size && is_diverse; j++){
+				is_diverse = columns[i].second != columns[j].second && jaccard_similarity(columns[i].second, columns[j].second) <= algo_conf.heur_jaccard;
+			}
+			if(is_diverse){
+				swap(columns[size++], columns[i]);
+			}
+		}
+		columns.resize(size);
+	}
+	if((columns.empty() || columns[0].first <= target_lb + tol) && algo_conf.grasp_iters > 0){
+		if(columns.empty()){ // the GRASP starts from the empty packing
+			columns.push_back(make_pair(0, vector<int>()));
+		}
+		solve_conic_knap_grasp(objs, mus, bs, Dalpha, capacity, numitems, conflict, algo_conf, budget, start, time_limit, target_lb, columns[0].second, columns[0].first);
+	}
+	//SCIPdebugMessage("quit heur,%lf\n", columns[0].first);
+	if(!columns.empty() && columns[0].first > target_lb +tol ){
+		sol_val = columns[0].first;
+	}
+	for(int i = 0; i < int(columns.size()); i++){
+		bool is_new = columns[i].first > target_lb + tol;
+		for(int j = 0; j < i && is_new; j++){ // the local search may lead to the same packing
+			is_new = columns[i].second != columns[j].second;
+		}
+		if(is_new){
+			sol_pool.push_back(list<int>(columns[i].second.begin(), columns[i].second.end()));
+		}
+	}
+};
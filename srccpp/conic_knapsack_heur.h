@@ -6,7 +6,29 @@
 #include "utilities.h"
 using namespace std;
 
-/** find a feasible solution for conic knapsack problem by heuristics
+/** find a feasible solution for conic knapsack problem by the multi-start best fit heuristic,
+*   the packings of the other starts with value greater than min_val are also returned
+*/
+void solve_conic_knap_best_fit(
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems, /** number of items */
+	const conflict_graph & conflict, /** the conflict graph*/
+	const dominance_index & dominance, /** the dominance index of the items */
+	int num_threads, /** number of threads */
+	work_budget & budget, /** the work budget */
+	chrono::steady_clock::time_point start, /** the start time of the heuristics */
+	SCIP_Real time_limit, /** solving time left after start */
+	SCIP_Real min_val, /** the minimal value of the other packings kept */
+    vector<int> & items_bin, /* items in the maximal bin, assumed to be sorted */
+	SCIP_Real & sol_val, /** solution value */
+	vector<pair<SCIP_Real, vector<int>>> & packings /** other packings with value greater than min_val, items are sorted */
+);
+
+/** find feasible solutions for conic knapsack problem by heuristics
 */
 void solve_conic_knap_heur(
 	const vector<SCIP_Real> & objs, /** objective coefficients of items */
@@ -15,10 +37,13 @@ void solve_conic_knap_heur(
 	SCIP_Real Dalpha, /** Dalpha */
 	SCIP_Real capacity, /** capacity */
 	int numitems, /** number of items */
-	const vector<pair<int,int>>& items_diff, /** items in same constraints */
 	const conflict_graph & conflict, /** the conflict graph*/
-	vector<int> & items_bin, /* items in the maximal bin, assumed to be sorted */
+	const dominance_index & dominance, /** the dominance index of the items */
+	const list<vector<int>> & warm_starts, /** packings of the last pricing rounds, sorted items */
+	const conf & algo_conf, /** algorithm configuration*/
+	list<list<int>> & sol_pool, /* solutions pools with values greater than target_lb, the best first, solution items are sorted */
 	SCIP_Real & sol_val, /** solution value */
+	work_budget & budget, /** the work budget */
 	SCIP_Real time_limit ,  /** solving time left */
 	SCIP_Real target_lb = 1.0 /* the tagret lower bound bound  */
 );
@@ -0,0 +1,125 @@
+/**@file   conic_knapsack_kernel.h
+ * @brief  Conic Knapsack capacity evaluation kernel of the heuristics
+ * @author Liding Xu
+ *---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#if defined(__AVX512F__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+#include "utilities.h"
+using namespace std;
+
+#define KERNEL_WIDTH 8 /* number of items evaluated by one kernel call */
+#define KERNEL_ALIGN 64 /* alignment in bytes of the kernel arrays */
+
+/* allocator of the aligned structure of arrays (mus, bs, objs) read by the kernel */
+template <class T>
+struct aligned_allocator{
+	typedef T value_type;
+
+	aligned_allocator() = default;
+
+	template <class U>
+	aligned_allocator(const aligned_allocator<U> &){}
+
+	T * allocate(size_t n){
+		size_t size = (n * sizeof(T) + KERNEL_ALIGN - 1) / KERNEL_ALIGN * KERNEL_ALIGN;
+		void * p = aligned_alloc(KERNEL_ALIGN, size > 0 ? size : KERNEL_ALIGN);
+		if(p == NULL){
+			throw bad_alloc();
+		}
+		return static_cast<T *>(p);
+	}
+
+	void deallocate(T * p, size_t){
+		free(p);
+	}
+
+	template <class U>
+	bool operator==(const aligned_allocator<U> &) const { return true; }
+
+	template <class U>
+	bool operator!=(const aligned_allocator<U> &) const { return false; }
+};
+
+typedef vector<SCIP_Real, aligned_allocator<SCIP_Real>> aligned_reals;
+
+/** the number of items rounded up to a multiple of the kernel width, the arrays are padded to this size */
+inline int kernel_padded_size(int numitems){
+	return (numitems + KERNEL_WIDTH - 1) / KERNEL_WIDTH * KERNEL_WIDTH;
+}
+
+/** the KERNEL_WIDTH bits of the block starting at the position p0 (a multiple of KERNEL_WIDTH) in a bitset */
+inline unsigned kernel_block_bits(const vector<uint64_t> & bitset, int p0){
+	return unsigned(bitset[p0 / 64] >> (p0 % 64)) & ((1u << KERNEL_WIDTH) - 1);
+}
+
+/** clear the bits of the block starting at the position p0 (a multiple of KERNEL_WIDTH) in a bitset */
+inline void kernel_clear_block_bits(vector<uint64_t> & bitset, int p0, unsigned bits){
+	bitset[p0 / 64] &= ~(uint64_t(bits) << (p0 % 64));
+}
+
+/** evaluate the conic capacity of the KERNEL_WIDTH items starting at mus and bs (aligned),
+ *   lhs_ = summu + mus + Dalpha * sqrt(sumb + bs), stores cap_use = lhs_ - lhs, and ratios = objs / cap_use if objs is not NULL,
+ *   returns the lanes of eligible that fit the capacity (lhs_ <= capacity).
+ *   cap_use and ratios are aligned arrays of KERNEL_WIDTH entries, lanes out of eligible hold garbage.
+*/
+inline unsigned conic_kernel(
+	const SCIP_Real * mus, /** mu of the items in the block */
+	const SCIP_Real * bs, /** b of the items in the block */
+	const SCIP_Real * objs, /** objective coefficients of the items in the block, or NULL */
+	unsigned eligible, /** bitmask of the eligible items in the block */
+	SCIP_Real summu, /** mu of the packed items */
+	SCIP_Real sumb, /** b of the packed items */
+	SCIP_Real lhs, /** capacity use of the packed items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	SCIP_Real * cap_use, /** capacity use increases of the items */
+	SCIP_Real * ratios /** efficiency ratios of the items */
+){
+#if defined(__AVX512F__)
+	__m512d lhs_ = _mm512_add_pd(_mm512_add_pd(_mm512_set1_pd(summu), _mm512_load_pd(mus)),
+		_mm512_mul_pd(_mm512_set1_pd(Dalpha), _mm512_sqrt_pd(_mm512_add_pd(_mm512_set1_pd(sumb), _mm512_load_pd(bs)))));
+	unsigned fit = _mm512_cmp_pd_mask(lhs_, _mm512_set1_pd(capacity), _CMP_LE_OQ);
+	__m512d use = _mm512_sub_pd(lhs_, _mm512_set1_pd(lhs));
+	_mm512_store_pd(cap_use, use);
+	if(objs != NULL){
+		_mm512_store_pd(ratios, _mm512_div_pd(_mm512_load_pd(objs), use));
+	}
+	return fit & eligible;
+#elif defined(__AVX__)
+	unsigned fit = 0;
+	for(int half = 0; half < KERNEL_WIDTH; half += 4){
+		__m256d lhs_ = _mm256_add_pd(_mm256_add_pd(_mm256_set1_pd(summu), _mm256_load_pd(mus + half)),
+			_mm256_mul_pd(_mm256_set1_pd(Dalpha), _mm256_sqrt_pd(_mm256_add_pd(_mm256_set1_pd(sumb), _mm256_load_pd(bs + half)))));
+		fit |= unsigned(_mm256_movemask_pd(_mm256_cmp_pd(lhs_, _mm256_set1_pd(capacity), _CMP_LE_OQ))) << half;
+		__m256d use = _mm256_sub_pd(lhs_, _mm256_set1_pd(lhs));
+		_mm256_store_pd(cap_use + half, use);
+		if(objs != NULL){
+			_mm256_store_pd(ratios + half, _mm256_div_pd(_mm256_load_pd(objs + half), use));
+		}
+	}
+	return fit & eligible;
+#else
+	unsigned fit = 0;
+	for(int lane = 0; lane < KERNEL_WIDTH; lane++){
+		if(!(eligible >> lane & 1u)){
+			continue;
+		}
+		SCIP_Real lhs_ = summu + mus[lane] + Dalpha * sqrt(sumb + bs[lane]);
+		if(lhs_ > capacity){
+			continue;
+		}
+		fit |= 1u << lane;
+		cap_use[lane] = lhs_ - lhs;
+		if(objs != NULL){
+			ratios[lane] = objs[lane] / cap_use[lane];
+		}
+	}
+	return fit;
+#endif
+}
@@ -10,14 +10,101 @@
 #include <ilcplex/ilocplex.h>
 #include <thread> 
 #include <mutex>  
+#include <atomic>
+#include <chrono>
+#include <fstream>
 
 
 
 
+/** refine the range [left_bd, right_bd] of the optimal value y of the extracted bound model by a binary search within time_limit seconds.
+ *   The first solve stops at the relative gap rel_eps_bd or at half of the time, then each iteration restricts y to the better half by test_row
+ *   and stops at the first feasible solution: a solution moves the bound of the incumbent side, an infeasible half moves the other bound.
+ *   The search stops early if the range is within rel_eps_bd * capacity, after max_iter solves or at the first solve without a conclusion.
+*/
+static void search_bd(
+	IloCplex & cplex, /** the solver with the extracted model */
+	IloRange & test_row, /** the range of y tested by the binary search */
+	bool is_max, /** y is maximized */
+	SCIP_Real capacity, /** capacity */
+	int max_iter, /** the maximum iteration of bound tightenning*/
+	SCIP_Real rel_eps_bd, /** relative tolerance of bound tightenning */
+   SCIP_Real & left_bd, /** left bound of the optimal value */
+   SCIP_Real & right_bd, /** right bound of the optimal value */
+	SOLTYPE_CKNAP & sol_type, /** solution type */
+   SCIP_Real time_limit /** solving time left */
+){
+	SCIP_Real start = cplex.getCplexTime();
+	SCIP_Real eps = rel_eps_bd * capacity;
+	bool found = false;
+	sol_type = Unknown;
+	cplex.setParam(IloCplex::Param::MIP::Tolerances::MIPGap, rel_eps_bd);
+	cplex.setParam(IloCplex::Param::TimeLimit, max_iter > 1 ? time_limit / 2 : time_limit);
+	cplex.solve();
+	if(cplex.getStatus() == IloAlgorithm::Infeasible){
+		sol_type = Infeasible;
+		return;
+	}
+	if(cplex.getStatus() == IloAlgorithm::Optimal || cplex.getStatus() == IloAlgorithm::Feasible){
+		found = true;
+		if(is_max){
+			left_bd = fmax(left_bd, cplex.getObjValue());
+			right_bd = fmin(right_bd, cplex.getBestObjValue());
+		}
+		else{
+			left_bd = fmax(left_bd, cplex.getBestObjValue());
+			right_bd = fmin(right_bd, cplex.getObjValue());
+		}
+	}
+	cplex.setParam(IloCplex::Param::MIP::Limits::Solutions, 1);
+	for(int iter = 1; iter < max_iter && right_bd - left_bd > eps; iter++){
+		SCIP_Real time_left = time_limit - (cplex.getCplexTime() - start);
+		if(time_left <= 0){
+			break;
+		}
+		SCIP_Real mid = (left_bd + right_bd) / 2;
+		if(is_max){
+			test_row.setLB(mid);
+		}
+		else{
+			test_row.setUB(mid);
+		}
+		cplex.setParam(IloCplex::Param::TimeLimit, time_left);
+		cplex.solve();
+		if(cplex.getStatus() == IloAlgorithm::Infeasible || cplex.getStatus() == IloAlgorithm::InfeasibleOrUnbounded){ // no y in the better half, y is bounded
+			if(is_max){
+				right_bd = mid;
+			}
+			else{
+				left_bd = mid;
+			}
+		}
+		else if(cplex.getStatus() == IloAlgorithm::Optimal || cplex.getStatus() == IloAlgorithm::Feasible){ // the optimum is in the tested half, so its bound is valid
+			found = true;
+			if(is_max){
+				left_bd = fmax(left_bd, cplex.getObjValue());
+				right_bd = fmin(right_bd, cplex.getBestObjValue());
+			}
+			else{
+				left_bd = fmax(left_bd, cplex.getBestObjValue());
+				right_bd = fmin(right_bd, cplex.getObjValue());
+			}
+		}
+		else{
+			break;
+		}
+	}
+	if(found){
+		sol_type = right_bd - left_bd <= eps ? Optimal : Feasible_Exact;
+	}
+}
+
+
 /** solve a conic knapsack problem to detemine the upper bound timie_limit,
  *   ub  = max y, mu* x == y,  D * sqrt(b * x) <= c -y. If summu > ub, no feaisbe solution
  *   If just a feasible solution is returned, it is not a valid upper bound.
  *   a binary search finds a valid upper bound y s.t. mu*x >=y, D * sqrt(b * x) <= c -y is infeasible.
+ *   The model has its own environment, so it can be solved concurrently with lb_miqcp.
 */
 void ub_micp(
 	const vector<SCIP_Real> & mus, /** mu of items */
@@ -25,9 +112,12 @@ void ub_micp(
 	SCIP_Real Dalpha, /** Dalpha */
 	SCIP_Real capacity, /** capacity */
 	int numitems, /** number of items */
-	const vector<pair<int,int>>& items_diff, /** items in same constraints */
-   SCIP_Real & left_bd, /** left bound of ub */
-   SCIP_Real & right_bd, /** right bound of ub */
+	const conflict_graph & conflict, /** the conflict graph*/
+	int max_iter, /** the maximum iteration of bound tightenning*/
+	SCIP_Real rel_eps_bd, /** relative tolerance of bound tightenning */
+	int num_threads, /** number of threads of CPLEX */
+   SCIP_Real & left_bd, /** left bound of ub, the value of a packing */
+   SCIP_Real & right_bd, /** right bound of ub, a valid upper bound */
 	SOLTYPE_CKNAP & sol_type, /** solution type */
    SCIP_Real time_limit /** solving time left */
 ){
@@ -54,40 +144,29 @@ void ub_micp(
 		}
 
 		// add the same and different constraints
-		for(auto pair_item: items_diff){
-			model.add(x_vars[pair_item.first] + x_vars[pair_item.second] <= 1);
-		} 
+		for(int item = 0; item < numitems; item++){
+			for(int item_: conflict.get_diffs(item)){
+				if(item < item_){
+					model.add(x_vars[item] + x_vars[item_] <= 1);
+				}
+			}
+		}
 		model.add(  expr_sum_mu_x  == y);
 		model.add( y +  Dalpha *z  <= capacity); 
 		model.add( expr_sum_xc2 <= z*z ); // second order cone constraint
+		IloRange test_row(env, 0.0, y, capacity); // y >= the tested value of the binary search
+		model.add(test_row);
 		model.add(IloMaximize(env, y)); // set the maximization objective
 
 		// Extract model.
 		cplex.extract(model);
 
-		// set the time limit in CPU seconds
-		cplex.setParam(IloCplex::Param::ClockType, 1);
-		cplex.setParam(IloCplex::Param::TimeLimit, time_limit);
+		// set the time limit in wall clock seconds, the CPU time counts the threads of both bound models
+		cplex.setParam(IloCplex::Param::ClockType, 2);
+		cplex.setParam(IloCplex::Param::Threads, num_threads);
 		cplex.setOut(env.getNullStream());
 
-		sol_type = Unknown;
-		cplex.solve();
-	if( cplex.getStatus() ==  IloAlgorithm::Infeasible){
-		sol_type = Infeasible;
-		}
-		else if(cplex.getStatus() ==  IloAlgorithm::Optimal || cplex.getStatus() ==  IloAlgorithm::Feasible){
-		left_bd = cplex.getObjValue();
-		right_bd = cplex.getBestObjValue();
-		if(cplex.getStatus() ==  IloAlgorithm::Optimal){
-			sol_type = Optimal;
-		}
-		else{
-			sol_type = Feasible_Exact;
-		}
-		}
-		else{
-		cout << "none";
-		}
+		search_bd(cplex, test_row, true, capacity, max_iter, rel_eps_bd, left_bd, right_bd, sol_type, time_limit);
 		env.end();
    } catch (IloException &e) {
       cerr << "IloException: " << e << endl;
@@ -106,7 +185,8 @@ void ub_micp(
 /** solve a mixed integer convex quadratically constrained problem to detemine the lower bound before timie_limit,
  *   lb = min y,  D*D*b*x >= (c-y)^2, mu * x<= y. If summu < lb, all mu*x <= summu, D*b*x <= (c -summu)*2
  *   If just a feasible solution is returned,  not a valid lower bound. 
- *    a binary search finds a valid upper bound y s.t. D*D*b*x >= (c-y)^2,  mu * x<= y is infeasibke
+ *    a binary search finds a valid lower bound y s.t. D*D*b*x >= (c-y)^2,  mu * x<= y is infeasible
+ *   The model has its own environment, so it can be solved concurrently with ub_micp.
 */
 void lb_miqcp(
 	const vector<SCIP_Real> & mus, /** mu of items */
@@ -114,9 +194,12 @@ void lb_miqcp(
 	SCIP_Real Dalpha, /** Dalpha */
 	SCIP_Real capacity, /** capacity */
 	int numitems, /** number of items */
-	const vector<pair<int,int>>& items_diff, /** items in same constraints */
-   SCIP_Real & left_bd, /** left bound of ub */
-   SCIP_Real & right_bd, /** right bound of ub */
+	const conflict_graph & conflict, /** the conflict graph*/
+	int max_iter, /** the maximum iteration of bound tightenning*/
+	SCIP_Real rel_eps_bd, /** relative tolerance of bound tightenning */
+	int num_threads, /** number of threads of CPLEX */
+   SCIP_Real & left_bd, /** left bound of lb, a valid lower bound */
+   SCIP_Real & right_bd, /** right bound of lb, the value of a solution */
 	SOLTYPE_CKNAP & sol_type, /** solution type */
    SCIP_Real time_limit /** solving time left */
 ){
@@ -141,39 +224,28 @@ void lb_miqcp(
          }
 
          // add the same and different constraints
-         for(auto pair_item: items_diff){
-               model.add(x_vars[pair_item.first] + x_vars[pair_item.second] <= 1);
-         } 
+         for(int item = 0; item < numitems; item++){
+            for(int item_: conflict.get_diffs(item)){
+               if(item < item_){
+                  model.add(x_vars[item] + x_vars[item_] <= 1);
+               }
+            }
+         }
 		 model.add(  expr_sum_mu_x  <= y);
          model.add(   Dalpha * Dalpha * expr_sum_b_x  >= (capacity - y)*(capacity - y)); 
+         IloRange test_row(env, 0.0, y, capacity); // y <= the tested value of the binary search
+         model.add(test_row);
          model.add(IloMinimize(env, y)); // set the minimization objective
 
          // Extract model.
          cplex.extract(model);
 
-         // set the time limit in CPU seconds
-         cplex.setParam(IloCplex::Param::ClockType, 1);
-         cplex.setParam(IloCplex::Param::TimeLimit, time_limit);
+         // set the time limit in wall clock seconds, the CPU time counts the threads of both bound models
+         cplex.setParam(IloCplex::Param::ClockType, 2);
+         cplex.setParam(IloCplex::Param::Threads, num_threads);
          cplex.setOut(env.getNullStream());
 
-        sol_type = Unknown;
-		cplex.solve();
-        if( cplex.getStatus() ==  IloAlgorithm::Infeasible){
-            sol_type = Infeasible;
-         }
-         else if(cplex.getStatus() ==  IloAlgorithm::Optimal || cplex.getStatus() ==  IloAlgorithm::Feasible){
-            left_bd = cplex.getObjValue();
-            right_bd = cplex.getBestObjValue();
-            if(cplex.getStatus() ==  IloAlgorithm::Optimal){
-               sol_type = Optimal;
-            }
-            else{
-               sol_type = Feasible_Exact;
-            }
-         }
-         else{
-            cout << "none";
-         }
+         search_bd(cplex, test_row, false, capacity, max_iter, rel_eps_bd, left_bd, right_bd, sol_type, time_limit);
          env.end();
    } catch (IloException &e) {
       cerr << "IloException: " << e << endl;
@@ -191,79 +263,162 @@ void lb_miqcp(
 
 
 /**
- * @brief tightenning the bound of milp piece-wise linear relaxation
+ * @brief tightenning the bound of milp piece-wise linear relaxation,
+ *  the upper bound and the lower bound models are solved concurrently, each in its own thread and environment with half of the threads
  */
 void rel_milp_bd(
-	SCIP * scip,
 	const vector<SCIP_Real> & mus, /** mu of items */
 	const vector<SCIP_Real> & bs, /** b of items */
 	SCIP_Real Dalpha, /** Dalpha */
 	SCIP_Real capacity, /** capacity */
 	int numitems, /** number of items */
-	const vector<pair<int,int>>& items_diff, /** items in same constraints */
+	const conflict_graph & conflict, /** the conflict graph*/
 	SCIP_Real & lb, /*valid lower bound*/
 	SCIP_Real & ub, /*valid upper bound*/
 	int max_iter, /** the maximum iteration of bound tightenning*/
 	SCIP_Real rel_eps_bd, /** relative tolerance of bound tightenning */
 	SCIP_Real time_limit /** the time limit of bound tightenning*/
 ){
-	SCIP_Real valid_ub = capacity, valid_lb = 0; // valid upper/lower bound
 	SCIP_Real search_left_ub = 0,  search_left_lb = 0, search_right_ub = capacity,  search_right_lb = capacity; // binary search left/right upper/lower bound
-	SCIP_Real ub_time = time_limit, lb_time = time_limit; // set timie limit of search
 	SOLTYPE_CKNAP sol_type_ub = Unknown, sol_type_lb = Unknown; // exact algorithm status
-	SCIP_Real soltime_before,  soltime_after;
-	SCIP_Real test_ub, test_lb;
-
-	soltime_before	=SCIPgetSolvingTime(scip);
-	ub_micp( mus,  bs,  Dalpha, capacity,  numitems, items_diff,   search_left_ub,  search_right_ub ,  sol_type_ub, ub_time  ); // find upper bound
-	soltime_after	=SCIPgetSolvingTime(scip);
-	ub_time -= (soltime_after - soltime_before);
-	valid_ub = fmin(capacity, search_right_ub + tol);
-
-	soltime_before	=SCIPgetSolvingTime(scip);
-	lb_miqcp( mus,  bs,  Dalpha, capacity,  numitems, items_diff,  search_left_lb, search_right_lb,  sol_type_lb, lb_time);
-	soltime_after	=SCIPgetSolvingTime(scip);
-	lb_time -= (soltime_after - soltime_before);
-	valid_lb = fmax(0, search_left_lb - tol);
-	lb = valid_lb;
-	ub = valid_ub;
+	int num_threads = max(1, int(thread::hardware_concurrency()) / 2);
+
+	thread ub_thread([&](){
+		ub_micp( mus,  bs,  Dalpha, capacity,  numitems, conflict, max_iter, rel_eps_bd, num_threads, search_left_ub,  search_right_ub ,  sol_type_ub, time_limit); // find upper bound
+	});
+	lb_miqcp( mus,  bs,  Dalpha, capacity,  numitems, conflict, max_iter, rel_eps_bd, num_threads, search_left_lb, search_right_lb,  sol_type_lb, time_limit); // find lower bound
+	ub_thread.join();
+
+	lb = fmax(0, search_left_lb - tol);
+	ub = fmin(capacity, search_right_ub + tol);
 }
 
 
 
+#define SOC_MAX_EXTRA_CUTS 3 /* maximal number of cuts at the nearby infeasible subsets added with a rejected candidate */
+#define SOC_MIN_VIOLATION 1e-4 /* minimal relative violation of the user cuts at the relaxation points */
+
+
+/** the range of the SOC cut over the mu variable and the item variables */
+static IloRange soc_cut_range(
+	IloEnv env, /** environment */
+	const IloNumVar & mu_s, /** the mu variable */
+	const IloNumVarArray & x_s, /** variables of the items */
+	const soc_cut & cut, /** the cut */
+	SCIP_Real capacity /** capacity */
+){
+	IloExpr cut_expr(env);
+	cut_expr += mu_s;
+	for(size_t i = 0; i < cut.items.size(); i++){
+		cut_expr += cut.coefs[i] * x_s[cut.items[i]];
+	}
+	IloRange range(env, -IloInfinity, cut_expr, capacity + tol);
+	cut_expr.end();
+	return range;
+}
+
+
+/* scratch buffers of the callbacks of a CPLEX thread, they only grow,
+ *  so the callbacks do not allocate on the heap after their first calls in the thread, except for the CPLEX cuts */
+struct soc_scratch{
+	vector<int> covered; // items of the candidate
+	vector<int> order; // order of the items of the candidate
+	vector<soc_cut> cuts; // cuts of the rejected candidate
+	soc_cut cut; // cut at the relaxation point
+};
+static thread_local soc_scratch cb_scratch;
+
+
+/** lock-free minimum and maximum of the values of the CPLEX threads */
+static inline void atomic_min(atomic<SCIP_Real> & value, SCIP_Real val){
+	SCIP_Real cur = value.load(memory_order_relaxed);
+	while(val < cur && !value.compare_exchange_weak(cur, val, memory_order_relaxed));
+}
+
+static inline void atomic_max(atomic<SCIP_Real> & value, SCIP_Real val){
+	SCIP_Real cur = value.load(memory_order_relaxed);
+	while(val > cur && !value.compare_exchange_weak(cur, val, memory_order_relaxed));
+}
+
+
 // This is the class implementing the generic callback interface.
-// It has a main function
-//    - lazySOC: adds the second order cone separation cut as a lazy constraint.
+// It has three main functions
+//    - lazySOC: adds the second order cone separation cuts as lazy constraints.
+//    - sepSOC: adds the second order cone separation cut at the relaxation point as a user cut.
+//    - nodeInfo: records the range of mu of the relaxation points, only used by the knn learning of the breakpoints.
+// CPLEX keeps one generic callback per solver, so all the contexts of the relaxation model are handled here.
+// The callback is shared by the CPLEX threads, it only reads its data and works in the scratch buffers of the thread,
+// the range of mu is reduced by lock-free updates.
 //	
 class SOCCallback: public IloCplex::Callback::Function {
 
    public:
 	// Empty constructor is forbidden.
-	SOCCallback ()
-	{}
+	SOCCallback ();
 
 	// Copy constructor is forbidden.
 	SOCCallback(const SOCCallback &tocopy);
 
     // Variables for items in {0,1}.
     IloNumVarArray x_s;
+	// the mu variable, mu_s == mus^t x_s
+	IloNumVar mu_s;
 
-	// constraint data,
-	vector<SCIP_Real> mus, bs;
+	// constraint data, owned by the model
+	const vector<SCIP_Real> & mus, & bs;
 	SCIP_Real capacity, Dalpha;
 	int numitems;
+	bool is_usercut; // separate the relaxation points
+	bool is_mu_track; // record the range of mu of the relaxation points
+	atomic<SCIP_Real> min_mu, max_mu;
+	atomic<long long> num_calls; // number of recorded relaxation points
+	atomic<long long> time_ns; // time of recording the relaxation points in nanoseconds
+	vector<soc_cut> * found_cuts; // the cuts of the rejected candidates are collected here if it is not NULL
+	mutex * found_mutex; // guards found_cuts
+	cplex_model * abort_model; // the solve of this model is aborted at its good incumbents if it is not NULL
 
 	// Constructor with data.
 	SOCCallback(const IloNumVarArray & x_s_,
+					const IloNumVar & mu_s_,
 					const vector<SCIP_Real>  &mus_,
 					const vector<SCIP_Real>  &bs_,
 					const SCIP_Real capacity_,
 					const SCIP_Real Dalpha_,
-					const int numitems_):
-		x_s(x_s_), mus(mus_), bs(bs_), capacity(capacity_), Dalpha(Dalpha_), numitems(numitems_)
+					const int numitems_,
+					const bool is_usercut_,
+					const bool is_mu_track_,
+					vector<soc_cut> * found_cuts_,
+					mutex * found_mutex_,
+					cplex_model * abort_model_):
+		x_s(x_s_), mu_s(mu_s_), mus(mus_), bs(bs_), capacity(capacity_), Dalpha(Dalpha_), numitems(numitems_), is_usercut(is_usercut_),
+		is_mu_track(is_mu_track_), min_mu(MAXFLOAT), max_mu(0), num_calls(0), time_ns(0),
+		found_cuts(found_cuts_), found_mutex(found_mutex_), abort_model(abort_model_)
 	{
 	}
 
+	// reset the range of mu before a solve
+	inline void
+	resetMuTrack () {
+		min_mu = MAXFLOAT;
+		max_mu = 0;
+		num_calls = 0;
+		time_ns = 0;
+	}
+
+	// the cut at the packing of the items except skip_item (-1: none), sumb is b of this packing
+	inline void
+	packingCut (const vector<int> & items, int skip_item, SCIP_Real sumb, soc_cut & cut) const {
+		SCIP_Real coef = Dalpha / sqrt(sumb);
+		cut.items.clear();
+		cut.coefs.clear();
+		for(int item: items){
+			if(item != skip_item){
+				cut.items.push_back(item);
+				cut.coefs.push_back(bs[item] * coef);
+			}
+		}
+	}
+
 	// Lazy constraint callback to enforce the SOC constraints, i.e. mus^t x_s +Dalpha \sqrt{bs^t x_s} <= capacity
 	// If used then the callback is invoked for every integer feasible
 	// solution CPLEX finds. For solution x_s_
@@ -272,105 +427,114 @@ class SOCCallback: public IloCplex::Callback::Function {
 	// is satisfied. If not then it adds the violated constraint as lazy
 	// constraint:
 	//  Dalpha (( \sum_i  b_s[i] x_s_[i]  x_s[i] ) / sqrt{\sum_i bs[i]x_s_[i]}) <= capacity - \sum_i mus[i] x_s[i]
+	// The cuts at the supersets of the packing do not cut more, but the cuts at its infeasible subsets do,
+	// so the cuts at up to SOC_MAX_EXTRA_CUTS packings without one item of small weight are added as well.
 	inline void
 	lazySOC (const IloCplex::Callback::Context &context)  {
 		if ( !context.isCandidatePoint() )
 			throw IloCplex::Exception(-1, "Unbounded solution");
-		int coversize = 0;
+		soc_scratch & scratch = cb_scratch;
+		vector<int> & covered = scratch.covered;
+		covered.clear();
 		SCIP_Real  summu = 0, sumb = 0;
 		for(int item = 0; item < numitems; item++){
 			IloNum x_val = context.getCandidatePoint(x_s[item]);
 			if(IloRound(x_val) == 1){ // find non zero items in the solution
 				sumb += bs[item];
 				summu += mus[item];
-				coversize++;
+				covered.push_back(item);
 			}
 		}
 		//SCIPdebugMessage("summu: %f\n", summu);
 		if(summu + Dalpha*sqrt(sumb) < capacity + tol){ //  valid
 			return;
 		}
-		SCIP_Real coef = Dalpha / sqrt(sumb);
-		vector<SCIP_Real> coeffs(mus.begin(), mus.end());
-		for(int item = 0; item < numitems; item++){  // construct outer approximation cut
-			bool covered = IloRound(context.getCandidatePoint(x_s[item])) == 1;
-			if(covered){
-				coeffs[item] += bs[item]*coef;
+		IloEnv env = context.getEnv();
+		IloRangeArray cuts(env);
+		if(scratch.cuts.size() < SOC_MAX_EXTRA_CUTS + 1){
+			scratch.cuts.resize(SOC_MAX_EXTRA_CUTS + 1);
+		}
+		const soc_cut & cut = scratch.cuts[0];
+		packingCut(covered, -1, sumb, scratch.cuts[0]);
+		cuts.add(soc_cut_range(env, mu_s, x_s, cut, capacity));
+		int num_cuts = 1;
+
+		// the nearby infeasible subsets, dropping the items of the smallest weights in the cut
+		vector<int> & order = scratch.order;
+		order.resize(covered.size());
+		for(size_t i = 0; i < covered.size(); i++){
+			order[i] = i;
+		}
+		sort(order.begin(), order.end(), [&](int i1, int i2){ return mus[covered[i1]] + cut.coefs[i1] < mus[covered[i2]] + cut.coefs[i2]; });
+		for(int i: order){
+			if(num_cuts > SOC_MAX_EXTRA_CUTS || covered.size() <= 1){
+				break;
+			}
+			int item = covered[i];
+			if(summu - mus[item] + Dalpha * sqrt(sumb - bs[item]) < capacity + tol || sumb - bs[item] <= 0){
+				continue;
 			}
+			packingCut(covered, item, sumb - bs[item], scratch.cuts[num_cuts]);
+			cuts.add(soc_cut_range(env, mu_s, x_s, scratch.cuts[num_cuts], capacity));
+			num_cuts++;
 		}
-		IloNumExpr coeffs_expr = IloExpr(context.getEnv());
-		for(int item =0; item < numitems; item++){
-			coeffs_expr += coeffs[item]*x_s[item];
+		context.rejectCandidate(cuts);
+		if(found_cuts != NULL){
+			lock_guard<mutex> lock(*found_mutex);
+			found_cuts->insert(found_cuts->end(), scratch.cuts.begin(), scratch.cuts.begin() + num_cuts);
 		}
-		SCIP_Real rhs = capacity + tol;
-		context.rejectCandidate(coeffs_expr <= rhs );
-		coeffs_expr.end();	
+		cuts.endElements();
+		cuts.end();
 	}
 
-	// This is the function that we have to implement and that CPLEX will call
-	// during the solution process at the places that we asked for.
-	virtual void invoke (const IloCplex::Callback::Context &context) ILO_OVERRIDE;
-
-	/// Destructor
-	virtual ~SOCCallback(){};
-};
-
-
-// This is the class implementing the generic callback interface.
-// It has a main function
-//    - nodeInfo: print the node information.
-//	
-class NodeCallback: public IloCplex::Callback::Function {
-
-   public:
-	// Empty constructor is forbidden.
-	NodeCallback ()
-	{}
-
-	// Copy constructor is forbidden.
-	NodeCallback(const NodeCallback &tocopy);
-
-    // Variables for items in {0,1}.
-    IloNumVarArray x_s;
-
-	// constraint data,
-	vector<SCIP_Real> mus, bs;
-	SCIP_Real capacity, Dalpha;
-	int numitems, max_record;
-	SCIP_Real min_mu = MAXFLOAT, max_mu = 0;
-
-	// Constructor with data.
-	NodeCallback(const IloNumVarArray & x_s_,
-					const vector<SCIP_Real>  &mus_,
-					const vector<SCIP_Real>  &bs_,
-					const SCIP_Real capacity_,
-					const SCIP_Real Dalpha_,
-					const int numitems_):
-		x_s(x_s_), mus(mus_), bs(bs_), capacity(capacity_), Dalpha(Dalpha_), numitems(numitems_)
-	{
+	// User cut callback to separate the relaxation points x_s_ violating the SOC constraint
+	//    mus^t x_s + Dalpha ||diag(sqrt{bs}) x_s|| <= capacity,
+	// its tangent at x_s_ is added as a user cut if the relative violation is at least SOC_MIN_VIOLATION:
+	//  Dalpha (( \sum_i  b_s[i] x_s_[i]  x_s[i] ) / sqrt{\sum_i bs[i]x_s_[i]^2}) <= capacity - \sum_i mus[i] x_s[i]
+	inline void
+	sepSOC (const IloCplex::Callback::Context &context)  {
+		if(context.getRelaxationStatus(0) != IloCplex::CplexStatus::Optimal){
+			return;
+		}
+		soc_cut & cut = cb_scratch.cut;
+		cut.items.clear();
+		cut.coefs.clear();
+		SCIP_Real  summu = 0, sumb2 = 0;
+		for(int item = 0; item < numitems; item++){
+			IloNum x_val = context.getRelaxationPoint(x_s[item]);
+			if(x_val > tol){
+				summu += mus[item] * x_val;
+				sumb2 += bs[item] * x_val * x_val;
+				cut.items.push_back(item);
+				cut.coefs.push_back(bs[item] * x_val);
+			}
+		}
+		if(sumb2 <= 0 || summu + Dalpha * sqrt(sumb2) < capacity * (1 + SOC_MIN_VIOLATION)){
+			return;
+		}
+		SCIP_Real coef = Dalpha / sqrt(sumb2);
+		for(SCIP_Real & c: cut.coefs){
+			c *= coef;
+		}
+		IloRange range = soc_cut_range(context.getEnv(), mu_s, x_s, cut, capacity);
+		context.addUserCut(range, IloCplex::UseCutPurge, IloFalse);
+		range.end();
 	}
 
-	// Lazy constraint callback to enforce the SOC constraints, i.e. mus^t x_s +Dalpha \sqrt{bs^t x_s} <= capacity
-	// If used then the callback is invoked for every integer feasible
-	// solution CPLEX finds. For solution x_s_
-	// constraint
-	//    mus^t x_s +Dalpha \sqrt{bs^t x_s} <= capacity
-	// is satisfied. If not then it adds the violated constraint as lazy
-	// constraint:
-	//  Dalpha (( \sum_i  b_s[i] x_s_[i]  x_s[i] ) / sqrt{\sum_i bs[i]x_s_[i]}) <= capacity - \sum_i mus[i] x_s[i]
+	// Relaxation callback to record the range of mu of the relaxation points,
+	// the range is the [min_mu, max_mu] of the points with optimal or infeasible relaxations:
+	//    min_mu <= mus^t x_s_ <= max_mu,
+	// mus^t x_s_ is the value of the mu variable, so a point costs one query instead of a loop over the items
 	inline void
 	nodeInfo (const IloCplex::Callback::Context &context)  {
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
 		if(context.getRelaxationStatus(0) == IloCplex::CplexStatus::Optimal || context.getRelaxationStatus(0) == IloCplex::CplexStatus::Infeasible){
-			SCIP_Real  summu = 0, sumb = 0;
-			for(int item = 0; item < numitems; item++){
-				IloNum x_val = context.getRelaxationPoint(x_s[item]);
-				sumb += bs[item] * x_val;
-				summu += mus[item] * x_val;
-			}
-			min_mu =   summu < min_mu ? summu : min_mu;
-			max_mu =   summu > max_mu ? summu : max_mu;
-			//SCIPdebugMessage("branch: summu: %f in [%f,%f]\n", summu, min_mu, max_mu);
+			SCIP_Real  summu = context.getRelaxationPoint(mu_s);
+			atomic_min(min_mu, summu);
+			atomic_max(max_mu, summu);
+			num_calls.fetch_add(1, memory_order_relaxed);
 		}
+		time_ns.fetch_add(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count(), memory_order_relaxed);
 	}
 
 	// This is the function that we have to implement and that CPLEX will call
@@ -378,9 +542,10 @@ class NodeCallback: public IloCplex::Callback::Function {
 	virtual void invoke (const IloCplex::Callback::Context &context) ILO_OVERRIDE;
 
 	/// Destructor
-	virtual ~NodeCallback(){};
+	virtual ~SOCCallback(){};
 };
 
+
 // Implementation of the invoke method.
 //
 // This is the method that we have to implement to fulfill the
@@ -391,13 +556,158 @@ SOCCallback::invoke (const IloCplex::Callback::Context &context)
 {
    if ( context.inCandidate() )
         lazySOC(context);
+   else if ( context.inRelaxation() ){
+        if ( is_mu_track )
+           nodeInfo(context);
+        if ( is_usercut )
+           sepSOC(context);
+   }
+   else if ( abort_model != NULL && context.inGlobalProgress() )
+        abort_model->abort_at_incumbent(context);
 }
 
-void
-NodeCallback::invoke (const IloCplex::Callback::Context &context)
-{
-   if ( context.inRelaxation() )
-        nodeInfo(context);
+/** merge the breakpoints pts into the breakpoints model_pts of a relaxation model, returns false if the bounds of the breakpoints differ.
+ *   The piecewise linear interpolation of the convex (c - x)^2 over the merged breakpoints is below the one over model_pts,
+ *   so they differ only between the old breakpoints around the new ones. local_pts holds the merged breakpoints of this range,
+ *   extended by the slopes of the first and the last pieces of the merged breakpoints, it is above the old interpolation outside the range.
+ *   local_pts is empty if there is no new breakpoint.
+*/
+static bool merge_breakpoints(
+	vector<pt_info> & model_pts, /** breakpoints of the model */
+	const vector<pt_info> & pts, /** breakpoints to merge */
+	vector<pt_info> & local_pts /** the merged breakpoints around the new ones */
+){
+	local_pts.clear();
+	const SCIP_Real eps = 1e-9;
+	if(model_pts.size() < 2 || pts.size() < 2 || fabs(model_pts.front().first - pts.front().first) > eps || fabs(model_pts.back().first - pts.back().first) > eps){
+		return false;
+	}
+	vector<pt_info> merged;
+	merged.reserve(model_pts.size() + pts.size());
+	int first_new = -1, last_new = -1;
+	size_t i = 0, j = 0;
+	while(i < model_pts.size() || j < pts.size()){
+		if(j == pts.size() || (i < model_pts.size() && model_pts[i].first < pts[j].first - eps)){
+			merged.push_back(model_pts[i++]);
+		}
+		else if(i == model_pts.size() || pts[j].first < model_pts[i].first - eps){
+			if(first_new == -1){
+				first_new = merged.size();
+			}
+			last_new = merged.size();
+			merged.push_back(pts[j++]);
+		}
+		else{
+			merged.push_back(model_pts[i++]);
+			j++;
+		}
+	}
+	if(first_new == -1){
+		return true;
+	}
+	local_pts.assign(merged.begin() + first_new - 1, merged.begin() + last_new + 2);
+	model_pts.swap(merged);
+	return true;
+}
+
+
+/** add b <= f(mu) to the model, f is the piecewise linear function over the breakpoints pts extended by the slopes, mu is in [0, mu_ub].
+ *   The formulations are
+ *   1: the CPLEX piecewise linear function,
+ *   2: SOS2, mu and f(mu) are convex combinations of two consecutive breakpoints given by a SOS2 of the weights,
+ *   3: incremental, the pieces are filled in order, a binary y_k forces the pieces before k + 1 to be full and allows the piece k + 1,
+ *   4: multi-choice, a binary y_k chooses the piece k and z_k is mu in the piece.
+ *   The formulations 2-4 cover [0, mu_ub] by breakpoints at 0 and mu_ub on the extensions of the first and the last pieces.
+*/
+static void add_pwl(
+	IloEnv env, /** environment */
+	IloModel model, /** the model */
+	IloNumVar mu, /** mu variable */
+	IloNumVar b, /** b variable */
+	const vector<pt_info> & pts, /** breakpoints */
+	SCIP_Real left_slope, /** slope before the first breakpoint */
+	SCIP_Real right_slope, /** slope after the last breakpoint */
+	SCIP_Real mu_ub, /** upper bound of mu */
+	int formulation /** the formulation */
+){
+	if(formulation == 1){
+		int num_pts = pts.size();
+		IloNumArray xs(env, num_pts);
+		IloNumArray fxs(env, num_pts);
+		for(int i = 0; i < num_pts; i++){
+			xs[i] = pts[i].first;
+			fxs[i] = pts[i].second;
+		}
+		model.add(b <= IloPiecewiseLinear(mu, left_slope, xs, fxs, right_slope));
+		return;
+	}
+	vector<pt_info> ext_pts;
+	if(pts.front().first > 0){
+		ext_pts.push_back(make_pair(0.0, pts.front().second - left_slope * pts.front().first));
+	}
+	ext_pts.insert(ext_pts.end(), pts.begin(), pts.end());
+	if(pts.back().first < mu_ub){
+		ext_pts.push_back(make_pair(mu_ub, pts.back().second + right_slope * (mu_ub - pts.back().first)));
+	}
+	int num_pts = ext_pts.size();
+	int num_pcs = num_pts - 1;
+	if(formulation == 2){ // SOS2
+		IloNumVarArray lambdas(env, num_pts, 0.0, 1.0, ILOFLOAT);
+		IloNumArray weights(env, num_pts);
+		IloExpr expr_sum(env), expr_mu(env), expr_f(env);
+		for(int i = 0; i < num_pts; i++){
+			weights[i] = i + 1;
+			expr_sum += lambdas[i];
+			expr_mu += ext_pts[i].first * lambdas[i];
+			expr_f += ext_pts[i].second * lambdas[i];
+		}
+		model.add(expr_sum == 1);
+		model.add(expr_mu == mu);
+		model.add(b <= expr_f);
+		model.add(IloSOS2(env, lambdas, weights));
+		expr_sum.end();
+		expr_mu.end();
+		expr_f.end();
+	}
+	else if(formulation == 3){ // incremental
+		IloNumVarArray deltas(env, num_pcs, 0.0, 1.0, ILOFLOAT);
+		IloExpr expr_mu(env), expr_f(env);
+		expr_mu += ext_pts[0].first;
+		expr_f += ext_pts[0].second;
+		for(int k = 0; k < num_pcs; k++){
+			expr_mu += (ext_pts[k + 1].first - ext_pts[k].first) * deltas[k];
+			expr_f += (ext_pts[k + 1].second - ext_pts[k].second) * deltas[k];
+			if(k + 1 < num_pcs){
+				IloNumVar y(env, 0.0, 1.0, ILOBOOL);
+				model.add(deltas[k + 1] <= y);
+				model.add(y <= deltas[k]);
+			}
+		}
+		model.add(expr_mu == mu);
+		model.add(b <= expr_f);
+		expr_mu.end();
+		expr_f.end();
+	}
+	else{ // multi-choice
+		IloNumVarArray y_vars(env, num_pcs, 0.0, 1.0, ILOBOOL);
+		IloNumVarArray z_vars(env, num_pcs, 0.0, mu_ub, ILOFLOAT);
+		IloExpr expr_y(env), expr_mu(env), expr_f(env);
+		for(int k = 0; k < num_pcs; k++){
+			SCIP_Real x0 = ext_pts[k].first, fx0 = ext_pts[k].second;
+			SCIP_Real x1 = ext_pts[k + 1].first, fx1 = ext_pts[k + 1].second;
+			model.add(x0 * y_vars[k] <= z_vars[k]);
+			model.add(z_vars[k] <= x1 * y_vars[k]);
+			expr_y += y_vars[k];
+			expr_mu += z_vars[k];
+			expr_f += fx0 * y_vars[k] + ((fx1 - fx0) / (x1 - x0)) * (z_vars[k] - x0 * y_vars[k]);
+		}
+		model.add(expr_y == 1);
+		model.add(expr_mu == mu);
+		model.add(b <= expr_f);
+		expr_y.end();
+		expr_mu.end();
+		expr_f.end();
+	}
 }
 
 
@@ -411,8 +721,10 @@ void solve_conic_rel_milp_cut(
 	SCIP_Real Dalpha, /** Dalpha */
 	SCIP_Real capacity, /** capacity */
 	int numitems, /** number of items */
-	const vector<pair<int,int>>& items_diff, /** items in same constraints */
+	const conflict_graph & conflict, /** the conflict graph*/
 	BreakPoints & breakpoints, /* quadratic Estimator */
+	cplex_model & model, /** the persistent relaxation model */
+	const list<vector<int>> & mip_starts, /** feasible packings passed as MIP starts, sorted items */
 	const conf & algo_conf, /** algorithm configuration*/
 	SCIP_Real time_limit ,  /** solving time left */
 	SCIP_Real target_lb, /* the tagret lower bound bound  */
@@ -422,117 +734,147 @@ void solve_conic_rel_milp_cut(
 	SCIP_Real & sol_ub, /** solution value upper bound */
     SOLTYPE_CKNAP & sol_type, /** solution type */
 	SCIP_Real & mu_val_rel, /** solution mu */
-	SCIP_Real & sol_time /** solution time */
+	SCIP_Real & sol_time, /** solution time */
+	stat & stat_prc, /** statistic of pricing */
+	work_budget & budget /** the work budget */
 ){
 	const list<pt_info> & break_points = breakpoints.get_break_points();
-	const SCIP_Real left_slope = breakpoints.get_left_slope();
-	const SCIP_Real right_slope = breakpoints.get_right_slope();
 	const SCIP_Real lb = breakpoints.get_lb();
 	const SCIP_Real ub = breakpoints.get_ub();
-	const int num_bps =  break_points.size();
 
-    IloEnv env;
+	// the breakpoints of the model are refined in place, the relaxation is built again if the items, their conflicts or the bounds of the breakpoints change
+	vector<pt_info> local_pts;
+	if(model.built && (!model.same_structure(mus, bs, Dalpha, capacity, numitems, conflict) || model.num_refinements >= PWL_MAX_REFINEMENTS
+		|| !merge_breakpoints(model.sample_pts, vector<pt_info>(break_points.begin(), break_points.end()), local_pts))){
+		model.clear();
+	}
+	if(model.built && model.sample_pts.size() != break_points.size()){ // the model is finer, continue the refinement from its breakpoints
+		vector<SCIP_Real> xs;
+		for(const pt_info & pt: model.sample_pts){
+			xs.push_back(pt.first);
+		}
+		breakpoints = BreakPoints(breakpoints.getCap(), lb, ub, xs);
+	}
+	const SCIP_Real left_slope = breakpoints.get_left_slope();
+	const SCIP_Real right_slope = breakpoints.get_right_slope();
+
+    IloEnv env = model.env;
     try {
-		// Create the model, populate by row
-		IloModel model(env);
-		IloNumVarArray x_vars(env, numitems);
-		IloNumVar mu(env, 0.0, ub, ILOFLOAT); 
-		IloNumVar b(env, 0.0, capacity* capacity, ILOFLOAT); 
-		IloNumVar quad(env, 0.0, capacity*capacity, ILOFLOAT);
-		IloNumArray sample_xs(env, break_points.size() );
-		IloNumArray sample_fxs(env, break_points.size());
+		if(!model.built){
+			// Create the model, populate by row
+			model.model = IloModel(env);
+			model.x_vars = IloNumVarArray(env, numitems);
+			model.set_structure(mus, bs, Dalpha, capacity, numitems, conflict);
+			model.sample_pts.assign(break_points.begin(), break_points.end());
+			model.mu_var = IloNumVar(env, 0.0, ub, ILOFLOAT); 
+			model.b_var = IloNumVar(env, 0.0, capacity* capacity, ILOFLOAT); 
+			IloModel & model_ = model.model;
+			IloNumVarArray & x_vars = model.x_vars;
+			IloNumVar & mu = model.mu_var; 
+			IloNumVar & b = model.b_var; 
+			IloNumVar quad(env, 0.0, capacity*capacity, ILOFLOAT);
 
-		IloExpr expr_sum_mu_x(env);
-		IloExpr expr_sum_b_x(env);
-		IloExpr expr_obj(env);
-		IloExpr expr_pl(env); 
-		for(int item = 0; item < numitems; item++){
-			x_vars[item] = IloNumVar(env, 0.0, 1.0, ILOBOOL); // add the binary variable for knapsack
-			expr_sum_mu_x +=  mus[item] * x_vars[item];
-			expr_sum_b_x += bs[item] * x_vars[item];
-			expr_obj += objs[item]  * x_vars[item];           
-		}
-		// add the same and different constraints
-		for(auto pair_item: items_diff){
-			model.add(x_vars[pair_item.first] + x_vars[pair_item.second] <= 1);
-		} 
+			IloExpr expr_sum_mu_x(env);
+			IloExpr expr_sum_b_x(env);
+			IloExpr expr_obj(env);
+			IloExpr expr_pl(env); 
+			for(int item = 0; item < numitems; item++){
+				x_vars[item] = IloNumVar(env, 0.0, 1.0, ILOBOOL); // add the binary variable for knapsack
+				expr_sum_mu_x +=  mus[item] * x_vars[item];
+				expr_sum_b_x += bs[item] * x_vars[item];
+				expr_obj += objs[item]  * x_vars[item];           
+			}
+			// add the same and different constraints
+			for(int item = 0; item < numitems; item++){
+				for(int item_: conflict.get_diffs(item)){
+					if(item < item_){
+						model_.add(x_vars[item] + x_vars[item_] <= 1);
+					}
+				}
+			}
 
-		int i = 0;
-		for(auto it = break_points.begin(); it != break_points.end(); it++){
-			sample_xs[i]= it->first; 
-			sample_fxs[i] = it->second; 
-			i++;
-		}
+			add_pwl(env, model_, mu, b, model.sample_pts, left_slope, right_slope, ub, algo_conf.pwl_formulation);
 
-		bool explicit_pwl = true;
-		if(explicit_pwl)
-		{
-			model.add(b <= IloPiecewiseLinear(mu, left_slope, sample_xs,  sample_fxs, right_slope));
-		}
-		else{
-			// multi choice model
-			int num_pcs = num_bps - 1;
-			IloExpr expr_mcobj(env); 
-			IloExpr expr_mcvar(env); 
-			IloNumVarArray y_vars(env, num_pcs);
-			IloNumVarArray z_vars(env, num_pcs);
-			expr_mcvar += lb;
-			auto p = break_points.begin();
-			for(int  i = 0; i < num_pcs; i++){
-				SCIP_Real x0 = p->first;
-				SCIP_Real fx0 = p->second;
-				p++;
-				SCIP_Real x1 = p->first;
-				SCIP_Real fx1 = p->second;		
-				y_vars[i] = IloNumVar(env, 0.0, 1.0, ILOBOOL);
-				z_vars[i] = IloNumVar(env, 0.0, (x1 - lb), ILOFLOAT);		
-				model.add((x0 - lb) * y_vars[i] <= z_vars[i]);
-				model.add(z_vars[i] <= (x1 - lb) * y_vars[i]);	
-				expr_mcvar += z_vars[i];
-				expr_mcobj += fx0 * y_vars[i] + ((fx1 - fx0) / (x1 - x0)) * (z_vars[i] - (x0 - lb) * y_vars[i]);
+			model_.add(  expr_sum_mu_x   == mu); 
+			for(const soc_cut & cut: model.init_cuts){ // the cuts of the cut pool
+				model_.add(soc_cut_range(env, mu, x_vars, cut, capacity));
 			}
-			model.add(expr_mcvar == mu);
-			model.add(b <= expr_mcobj);
-			model.add(b <= IloPiecewiseLinear(mu, left_slope, sample_xs,  sample_fxs, right_slope));
-			IloSOS1(env, y_vars);
-		}
-
-		model.add(  expr_sum_mu_x   == mu); 
-		model.add(  Dalpha*Dalpha * expr_sum_b_x    ==  b); 
-        model.add(  expr_obj  >= (target_lb - tol)); 
-		model.add(IloMaximize(env, expr_obj)); // set the maximization objective
-
-		// set cplex
-		IloCplex cplex(model);
-		cplex.setParam(IloCplex::Param::ClockType, 1);
-		cplex.setParam(IloCplex::Param::TimeLimit, time_limit);
-		cplex.setParam(IloCplex::Param::Emphasis::MIP, 3);
-		cplex.setParam(IloCplex::Param::Threads,algo_conf.is_parallelscplex ? 0 : 1);
-		cplex.setOut(env.getNullStream());
+			model_.add(  Dalpha*Dalpha * expr_sum_b_x    ==  b); 
+			model.target_row = IloRange(env, target_lb - tol, expr_obj, IloInfinity);
+	        model_.add(model.target_row); 
+			model.obj = IloMaximize(env, expr_obj);
+			model_.add(model.obj); // set the maximization objective
+
+			// set cplex
+			model.cplex = IloCplex(model_);
+			model.cplex.setParam(IloCplex::Param::ClockType, 1);
+			model.cplex.setParam(IloCplex::Param::Emphasis::MIP, 3);
+			model.cplex.setOut(env.getNullStream());
+			model.aborter = IloCplex::Aborter(env);
+			model.cplex.use(model.aborter);
 		
 		
-		SOCCallback cb( x_vars, mus, bs, capacity, Dalpha, numitems);
-		NodeCallback ncb( x_vars, mus, bs, capacity, Dalpha, numitems);
-		CPXLONG contextMask = 0;
-		contextMask |= IloCplex::Callback::Context::Id::Candidate;
-		contextMask |= IloCplex::Callback::Context::Id::Relaxation;
+			bool is_mu_track = algo_conf.knn_mode != 1; // the range of mu is only learned by the knn regression
+			SOCCallback * cb = new SOCCallback( x_vars, mu, model.mus, model.bs, capacity, Dalpha, numitems, algo_conf.is_soc_usercut, is_mu_track,
+				algo_conf.cut_pool_size > 0 ? &model.found_cuts : NULL, &model.found_mutex, algo_conf.exact_abort_ratio < 1 ? &model : NULL);
+			model.callbacks.push_back(cb);
+			CPXLONG contextMask = 0;
+			contextMask |= IloCplex::Callback::Context::Id::Candidate;
+			if(algo_conf.is_soc_usercut || is_mu_track){
+				contextMask |= IloCplex::Callback::Context::Id::Relaxation;
+			}
+			if(algo_conf.exact_abort_ratio < 1){ // the incumbents are conic feasible, stop at the good ones
+				contextMask |= IloCplex::Callback::Context::Id::GlobalProgress;
+			}
 
-      	// If contextMask is not zero we add the callback.
-      	if ( contextMask != 0 ){
-         	cplex.use(&cb, contextMask);
-			cplex.use(&ncb, contextMask);
+	      	// If contextMask is not zero we add the callback, it is the only generic callback of the solver.
+	      	if ( contextMask != 0 ){
+	         	model.cplex.use(cb, contextMask);
+			}
+			model.built = true;
+		}
+		else{
+			if(!local_pts.empty()){ // add the refined pieces, the search state and the incumbent of the model are kept
+				add_pwl(env, model.model, model.mu_var, model.b_var, local_pts, left_slope, right_slope, ub, algo_conf.pwl_formulation);
+				model.num_refinements++;
+			}
+			model.update(objs, target_lb);
+		}
+		IloCplex & cplex = model.cplex;
+		IloNumVarArray & x_vars = model.x_vars;
+		SOCCallback * cb = static_cast<SOCCallback *>(model.callbacks[0]);
+		if(cb->is_mu_track){
+			cb->resetMuTrack();
+		}
+		cplex.setParam(IloCplex::Param::Threads,algo_conf.is_parallelscplex ? model.num_threads : 1);
+		if(algo_conf.is_mip_start){
+			model.set_mip_starts(objs, mip_starts, target_lb);
 		}
 
         sol_type = Unknown;
-        cplex.solve();
+		size_t num_found = model.found_cuts.size();
+		model.aborted = false;
+        model.solve(budget, time_limit);
 		sol_time = cplex.getTime();
+		for(size_t i = num_found; i < model.found_cuts.size(); i++){ // the cuts of the rejected candidates stay in the model for the next rounds
+			model.model.add(soc_cut_range(env, model.mu_var, model.x_vars, model.found_cuts[i], capacity));
+		}
 		if( cplex.getStatus() ==  IloAlgorithm::Infeasible){
 			printf("infeas\n");
             sol_type = Infeasible;
         }
         else if(cplex.getStatus() ==  IloAlgorithm::Optimal || cplex.getStatus() ==  IloAlgorithm::Feasible){
-			mubd.first = ncb.min_mu > ub ? lb: ncb.min_mu;
-			mubd.second = ncb.max_mu < lb ? ub: ncb.max_mu;
+			if(cb->is_mu_track){
+				SCIP_Real min_mu = cb->min_mu.load(), max_mu = cb->max_mu.load();
+				mubd.first = min_mu > ub ? lb: min_mu;
+				mubd.second = max_mu < lb ? ub: max_mu;
+				stat_prc.num_mu_track += cb->num_calls.load();
+				stat_prc.time_mu_track += cb->time_ns.load() * 1e-9;
+			}
+			else{
+				mubd.first = lb;
+				mubd.second = ub;
+			}
 			SCIP_Real summu = 0, sumb = 0;
 			list<int> items_bin;
             for(int item = 0; item < numitems; item++){
@@ -554,6 +896,7 @@ void solve_conic_rel_milp_cut(
             }
 			if(summu + Dalpha*sqrt(sumb) < capacity + tol){
 				sol_pool.push_back(items_bin);
+				model.harvest_pool(objs, mus, bs, Dalpha, capacity, target_lb, algo_conf.exact_columns, sol_pool); // only when the incumbent is conic feasible, so sol_val stays its value
 			}
          }
          else{
@@ -561,26 +904,82 @@ void solve_conic_rel_milp_cut(
          }
 	} catch (IloException &e) {
 		cerr << "IloException at relaxed MILP: " << e << endl;
-		if (env.getImpl())
-			env.end();
+		model.clear();
 		::abort();
 	} catch (string& e) {
 		cerr << e << "unkonown error"<< endl;
-		if (env.getImpl())
-			env.end();
+		model.clear();
 		::abort();
 	} 
-	env.end();
 };
 
 
 
 
+/** append the pricing problem to the file, the format is read by read_pricing */
+void record_pricing(
+	const string & filename, /** the file */
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems, /** number of items */
+	const conflict_graph & conflict, /** the conflict graph*/
+	SCIP_Real target_lb /* the tagret lower bound bound  */
+){
+	ofstream out(filename, ios::app);
+	out.precision(17);
+	out << numitems << " " << Dalpha << " " << capacity << " " << target_lb << "\n";
+	for(int item = 0; item < numitems; item++){
+		out << objs[item] << " " << mus[item] << " " << bs[item] << "\n";
+	}
+	out << conflict.num_diffs() << "\n";
+	for(int item = 0; item < numitems; item++){
+		for(int item_: conflict.get_diffs(item)){
+			if(item < item_){
+				out << item << " " << item_ << "\n";
+			}
+		}
+	}
+}
+
+
+/** read the next pricing problem of the stream written by record_pricing, returns false at the end of the stream */
+bool read_pricing(
+	istream & in, /** the stream */
+	vector<SCIP_Real> & objs, /** objective coefficients of items */
+	vector<SCIP_Real> & mus, /** mu of items */
+	vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real & Dalpha, /** Dalpha */
+	SCIP_Real & capacity, /** capacity */
+	int & numitems, /** number of items */
+	vector<pair<int, int>> & diffs, /** the conflicts */
+	SCIP_Real & target_lb /* the tagret lower bound bound  */
+){
+	if(!(in >> numitems >> Dalpha >> capacity >> target_lb)){
+		return false;
+	}
+	objs.resize(numitems);
+	mus.resize(numitems);
+	bs.resize(numitems);
+	for(int item = 0; item < numitems; item++){
+		in >> objs[item] >> mus[item] >> bs[item];
+	}
+	int num_diffs = 0;
+	in >> num_diffs;
+	diffs.resize(num_diffs);
+	for(int i = 0; i < num_diffs; i++){
+		in >> diffs[i].first >> diffs[i].second;
+	}
+	return bool(in);
+}
+
+
 /** solve conic knapsack problem via PWLBC before timie_limit,
 *   either find a high quality solution with the value greater than the tagret lower bound,  or conclude that there is no such solution
 */
 void solve_conic_knap_pwlbc(
-	SCIP * scip,
 	stat & stat_prc, /** statistic of pricing */
 	const vector<SCIP_Real> & objs, /** objective coefficients of items */
 	const vector<SCIP_Real> & mus, /** mu of items */
@@ -588,18 +987,26 @@ void solve_conic_knap_pwlbc(
 	SCIP_Real Dalpha, /** Dalpha */
 	SCIP_Real capacity, /** capacity */
 	int numitems, /** number of items */
-	Estimator & init_estimator, /** initial estimator*/
+	Estimator & init_estimator, /** initial estimator, only read by the knn regression */
 	const conf & algo_conf, /** algorithm configuration*/
 	SCIP_Real heur_mu,/* heur mu*/
-	const vector<pair<int,int>>& items_diff, /** items in same constraints */
 	const conflict_graph & conflict, /** the conflict graph*/
+	cplex_model & model, /** the persistent relaxation model */
+	const list<vector<int>> & mip_starts, /** feasible packings passed as MIP starts, sorted items */
     list<list<int>> & sol_pool, /* solutions pools, solution items are assumed to be sorted */
 	SCIP_Real & sol_val, /** solution value */
 	SCIP_Real & sol_ub, /** solution value upper bound */
 	SOLTYPE_CKNAP & sol_type, /** solution type */
-    SCIP_Real time_limit,  /** solving time left */
+	vector<pair<SCIP_Real, SCIP_Real>> & mu_samples, /** the ranges of mu of the solved relaxations learned by the knn regression */
+	work_budget & budget, /** the work budget of all the refinements */
+	SCIP_Real scip_time_left, /** solving time left of SCIP at the start */
+    SCIP_Real time_limit,  /** solving time left of each relaxation */
     SCIP_Real target_lb /* the tagret lower bound bound  */
 ){
+	auto start = chrono::steady_clock::now();
+	if(!algo_conf.pricing_record.empty()){
+		record_pricing(algo_conf.pricing_record, objs, mus, bs, Dalpha, capacity, numitems, conflict, target_lb);
+	}
 	SCIP_Real timelimit;
 	SCIP_Real sol_time;
 	BreakPoints breakpoints(init_estimator.breakpoints);
@@ -607,22 +1014,20 @@ void solve_conic_knap_pwlbc(
 	// query knn results 
 	SCIP_Real knn_time;
 	pair<SCIP_Real,SCIP_Real> knn_mubd;
-	if(algo_conf.knn_mode !=1 && !SCIPisEQ(scip, algo_conf.point_ratio,  1)){
-		SCIP_Real knn_start = SCIPgetSolvingTime(scip);
+	if(algo_conf.knn_mode !=1 && fabs(algo_conf.point_ratio - 1) > tol){
+		auto knn_start = chrono::steady_clock::now();
 		vector<pair<SCIP_Real,SCIP_Real>> knn_results;
 		knn_mubd = init_estimator.knnregression(objs, algo_conf.kneighbors, knn_results, algo_conf.knn_mode);
 		BreakPoints concen_breakpoints(breakpoints.getCap(), breakpoints.get_lb(), breakpoints.get_ub(), breakpoints.getNum(), knn_mubd.first, knn_mubd.second, algo_conf.point_ratio);	
 		bb_breakpoints = concen_breakpoints;
-		knn_time = SCIPgetSolvingTime(scip) - knn_start;
+		knn_time = chrono::duration<SCIP_Real>(chrono::steady_clock::now() - knn_start).count();
 		stat_prc.cum_knn_time += knn_time;
 	}
 	
 	int num_iter = 0;
 	while(true){
-		SCIPgetRealParam(scip, "limits/time", &timelimit) ;
-		if( !SCIPisInfinity(scip, timelimit) )
-			timelimit -= SCIPgetSolvingTime(scip);
-		if(timelimit < 0){
+		timelimit = scip_time_left - chrono::duration<SCIP_Real>(chrono::steady_clock::now() - start).count();
+		if(timelimit < 0 || (budget.is_det() && budget.left() <= 0) || budget.is_cancelled()){
 			return;
 		}
 		timelimit  = timelimit < time_limit ? timelimit : time_limit;
@@ -630,10 +1035,12 @@ void solve_conic_knap_pwlbc(
 		SOLTYPE_CKNAP sol_type_rel = Unknown;
 		SCIP_Real sol_val_rel = 0, sol_ub_rel = MAXFLOAT, mu_val_rel = 0;
 		pair<SCIP_Real, SCIP_Real> mubd; /* lower and upper bound of mu*/
-		solve_conic_rel_milp_cut(objs,  mus,  bs,  Dalpha,  capacity,  numitems,  items_diff, bb_breakpoints, algo_conf, timelimit,  target_lb, sol_pool, mubd, sol_val_rel,  sol_ub_rel,  sol_type_rel, mu_val_rel, sol_time); // solve the relaxation
+		solve_conic_rel_milp_cut(objs,  mus,  bs,  Dalpha,  capacity,  numitems,  conflict, bb_breakpoints, model, mip_starts, algo_conf, timelimit,  target_lb, sol_pool, mubd, sol_val_rel,  sol_ub_rel,  sol_type_rel, mu_val_rel, sol_time, stat_prc, budget); // solve the relaxation
 		stat_prc.cum_sol_time += sol_time;
-		// update estimator and knn
-		init_estimator.add(objs, mubd);
+		// the samples of the estimator and knn, mubd is only set by the solved relaxations
+		if(algo_conf.knn_mode != 1 && (sol_type_rel == Optimal || sol_type_rel == Feasible_Exact)){
+			mu_samples.push_back(mubd);
+		}
 		//SCIPdebugMessage("[%f, %f] [%f, %f] %f/%f %f/%f \n", knn_mubd.first, knn_mubd.second,  mubd.first, mubd.second,  sol_time, stat_prc.cum_sol_time, knn_time, stat_prc.cum_knn_time);
 		if(sol_type_rel == Infeasible){ // conclude no feasible pricing solution
 			sol_type = Infeasible;
@@ -644,9 +1051,6 @@ void solve_conic_knap_pwlbc(
 				sol_type =sol_type_rel;
 				sol_val = sol_val_rel;
 				sol_ub = sol_ub_rel;
-	    		SCIPgetRealParam(scip, "limits/time", &timelimit) ;
-				if( !SCIPisInfinity(scip, timelimit) )
-					timelimit -= SCIPgetSolvingTime(scip);
 				break;
 			}
 			else{
@@ -6,15 +6,18 @@
 #include <list>
 #include <tuple>
 #include <utility>
+#include <string>
+#include <istream>
 #include "utilities.h"
 #include "estimator.h"
+#include "pricing_model.h"
 using namespace std;
 
 /** solve conic knapsack problem before timie_limit,
-*   either find a solution with the value greater than the tagret lower bound,  or conclude that there is no such solution
+*   either find a solution with the value greater than the tagret lower bound,  or conclude that there is no such solution.
+*   It does not call SCIP, nor change the estimator, so it can run on a thread
 */
 void solve_conic_knap_pwlbc(
-	SCIP * scip,
 	stat & stat_prc, /** statistic of pricing */
 	const vector<SCIP_Real> & objs, /** objective coefficients of items */
 	const vector<SCIP_Real> & mus, /** mu of items */
@@ -22,16 +25,20 @@ void solve_conic_knap_pwlbc(
 	SCIP_Real Dalpha, /** Dalpha */
 	SCIP_Real capacity, /** capacity */
 	int numitems, /** number of items */
-    Estimator & init_estimator, /** initial estimator*/
+    Estimator & init_estimator, /** initial estimator, only read by the knn regression */
 	const conf & algo_conf, /** algorithm configuration*/
 	SCIP_Real heur_mu, /* heur mu*/
-	const vector<pair<int,int>>& items_diff, /** items in same constraints */
 	const conflict_graph & conflict, /** the conflict graph*/
+	cplex_model & model, /** the persistent relaxation model */
+	const list<vector<int>> & mip_starts, /** feasible packings passed as MIP starts, sorted items */
     list<list<int>> & sol_pool, /* solutions pools, solution items are assumed to be sorted */
 	SCIP_Real & sol_val, /** solution value */
 	SCIP_Real & sol_ub, /** solution value */
 	SOLTYPE_CKNAP & sol_type, /** solution type */
-    SCIP_Real time_limit = 3600,  /** solving time left */
+	vector<pair<SCIP_Real, SCIP_Real>> & mu_samples, /** the ranges of mu of the solved relaxations learned by the knn regression */
+	work_budget & budget, /** the work budget of all the refinements */
+	SCIP_Real scip_time_left, /** solving time left of SCIP at the start */
+    SCIP_Real time_limit = 3600,  /** solving time left of each relaxation */
     SCIP_Real target_lb = 1.0 /* the tagret lower bound bound  */
 );
 
@@ -39,16 +46,68 @@ void solve_conic_knap_pwlbc(
  * @brief tightenning the bound of milp piece-wise linear relaxation
  */
 void rel_milp_bd(
-	SCIP * scip,
 	const vector<SCIP_Real> & mus, /** mu of items */
 	const vector<SCIP_Real> & bs, /** b of items */
 	SCIP_Real Dalpha, /** Dalpha */
 	SCIP_Real capacity, /** capacity */
 	int numitems, /** number of items */
-	const vector<pair<int,int>>& items_diff, /** items in same constraints */
+	const conflict_graph & conflict, /** the conflict graph*/
 	SCIP_Real & lb, /*valid lower bound*/
 	SCIP_Real & ub, /*valid upper bound*/
 	int max_iter, /** the maximum iteration of bound tightenning*/
 	SCIP_Real rel_eps_bd, /** relative tolerance of bound tightenning */
 	SCIP_Real time_limit /** the time limit of bound tightenning*/
-);
\ No newline at end of file
+);
+
+
+/** solve the piecewise linear relaxation of the conic knapsack problem with the SOC cuts */
+void solve_conic_rel_milp_cut(
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems, /** number of items */
+	const conflict_graph & conflict, /** the conflict graph*/
+	BreakPoints & breakpoints, /* quadratic Estimator */
+	cplex_model & model, /** the persistent relaxation model */
+	const list<vector<int>> & mip_starts, /** feasible packings passed as MIP starts, sorted items */
+	const conf & algo_conf, /** algorithm configuration*/
+	SCIP_Real time_limit ,  /** solving time left */
+	SCIP_Real target_lb, /* the tagret lower bound bound  */
+    list<list<int>> & sol_pool, /* solutions pools, solution items are assumed to be sorted */
+	pair<SCIP_Real, SCIP_Real>& mubd, /* lower and upper bound of mu*/
+	SCIP_Real & sol_val, /** solution value */
+	SCIP_Real & sol_ub, /** solution value upper bound */
+    SOLTYPE_CKNAP & sol_type, /** solution type */
+	SCIP_Real & mu_val_rel, /** solution mu */
+	SCIP_Real & sol_time, /** solution time */
+	stat & stat_prc, /** statistic of pricing */
+	work_budget & budget /** the work budget */
+);
+
+/** append the pricing problem to the file, the format is read by read_pricing */
+void record_pricing(
+	const string & filename, /** the file */
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	int numitems, /** number of items */
+	const conflict_graph & conflict, /** the conflict graph*/
+	SCIP_Real target_lb /* the tagret lower bound bound  */
+);
+
+/** read the next pricing problem of the stream written by record_pricing, returns false at the end of the stream */
+bool read_pricing(
+	istream & in, /** the stream */
+	vector<SCIP_Real> & objs, /** objective coefficients of items */
+	vector<SCIP_Real> & mus, /** mu of items */
+	vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real & Dalpha, /** Dalpha */
+	SCIP_Real & capacity, /** capacity */
+	int & numitems, /** number of items */
+	vector<pair<int, int>> & diffs, /** the conflicts */
+	SCIP_Real & target_lb /* the tagret lower bound bound  */
+);
@@ -86,6 +86,28 @@ SCIP_RETCODE runShell(
    SCIP_CALL( SCIPaddIntParam(scip,  "cbp/knn_mode", " the mode of knn regression for learning breakpoints, 1: no knn search/learning, 2: uniformly weighted knn, 3: distance weighted knn",  NULL, FALSE, 1, 1, 3,  NULL, NULL) );
    SCIP_CALL( SCIPaddIntParam(scip,  "cbp/kneighbors","the number neighbors of knn regression",  NULL, FALSE, 1, 1, 10,  NULL, NULL) );
    SCIP_CALL( SCIPaddRealParam(scip,  "cbp/point_ratio","ratio of increasing breakpoints",  NULL, FALSE, 1, 1, 8,  NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,  "cbp/heur_threads","the number of threads of the multi-start heuristic pricing",  NULL, FALSE, 1, 1, 256,  NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,  "cbp/heur_columns","the maximal number of columns of the heuristic pricing",  NULL, FALSE, 1, 1, 1000,  NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,  "cbp/heur_jaccard","the maximal Jaccard similarity between two columns of the heuristic pricing",  NULL, FALSE, 0.5, 0, 1,  NULL, NULL) );
+   SCIP_CALL( SCIPaddBoolParam(scip, "cbp/is_local_search","improve the heuristic pricing solution by add/drop/swap local search",  NULL, FALSE, TRUE,  NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,  "cbp/grasp_iters","the maximal number of iterations of the GRASP heuristic pricing (0: disabled)",  NULL, FALSE, 0, 0, INT_MAX,  NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,  "cbp/grasp_alpha","the restricted candidate list parameter of the GRASP heuristic pricing",  NULL, FALSE, 0.2, 0, 1,  NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,  "cbp/grasp_seed","the random seed of the GRASP heuristic pricing",  NULL, FALSE, 0, 0, INT_MAX,  NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,  "cbp/warm_pool_size","the number of columns of the last pricing rounds at the same node used as seeds of the heuristic pricing",  NULL, FALSE, 0, 0, 1000,  NULL, NULL) );
+   SCIP_CALL( SCIPaddBoolParam(scip, "cbp/is_dp","solve the pricing problems without conflicts by the profit scaling dynamic programming first",  NULL, FALSE, FALSE,  NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,  "cbp/dp_eps","the approximation ratio of the dynamic programming",  NULL, FALSE, 0.05, 0.001, 0.5,  NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,  "cbp/dp_max_items","the maximal number of items of the dynamic programming",  NULL, FALSE, 100, 1, 10000,  NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,  "cbp/bb_max_items","the maximal number of items of the pricing problems solved by the combinatorial branch and bound (0: disabled)",  NULL, FALSE, 0, 0, 1000,  NULL, NULL) );
+   SCIP_CALL( SCIPaddBoolParam(scip, "cbp/is_rel_bound","stop the pricing if the continuous relaxation bound of the pricing problem is not improving",  NULL, FALSE, TRUE,  NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,  "cbp/exact_columns","the maximal number of columns of the exact pricing harvested from the CPLEX solution pool",  NULL, FALSE, 1, 1, 1000,  NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,  "cbp/exact_abort_ratio","the exact pricing stops at an incumbent above the early stopping value with at least this ratio of the best bound (1: disabled)",  NULL, FALSE, 1, 0, 1,  NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,  "cbp/pwl_formulation","the formulation of the piecewise linear relaxation of the PWLBC, 1: CPLEX piecewise linear, 2: SOS2, 3: incremental, 4: multi-choice",  NULL, FALSE, 1, 1, 4,  NULL, NULL) );
+   SCIP_CALL( SCIPaddStringParam(scip, "cbp/pricing_record","the file where the pricing problems solved by the PWLBC are appended (empty: disabled)",  NULL, FALSE, "",  NULL, NULL) );
+   SCIP_CALL( SCIPaddBoolParam(scip, "cbp/is_soc_usercut","separate the SOC constraint at the fractional relaxation points of the PWLBC by user cuts",  NULL, FALSE, TRUE,  NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,  "cbp/cut_pool_size","the maximal number of SOC cuts kept in the cut pool and reused by the later PWLBC models (0: disabled)",  NULL, FALSE, 1000, 0, 100000,  NULL, NULL) );
+   SCIP_CALL( SCIPaddBoolParam(scip, "cbp/is_mip_start","pass the heuristic and the last rounds' packings to the exact pricing as MIP starts",  NULL, FALSE, TRUE,  NULL, NULL) );
+   SCIP_CALL( SCIPaddRealParam(scip,  "cbp/work_rate","the pricing budgets are deterministic, work units per second of the time budgets (0: CPU time budgets)",  NULL, FALSE, 0, 0, 1e9,  NULL, NULL) );
+   SCIP_CALL( SCIPaddIntParam(scip,  "cbp/portfolio","race the heuristic and the exact pricing on threads, 0: disabled, 1: with the exact algorithm of cbp/is_misocp, 2: with the PWLBC and the MISOCP",  NULL, FALSE, 0, 0, 2,  NULL, NULL) );
 
    /* turn off all separation algorithms */
    SCIP_CALL( SCIPsetSeparating(scip, SCIP_PARAMSETTING_OFF, TRUE) );
@@ -81,6 +81,7 @@
 #include "scip/cons_setppc.h"
 #include "conic_knapsack.h"
 #include "conic_knapsack_pwlbc.h"
+#include "conic_knapsack_kernel.h"
 
 class UnionFindSet{
 public:
@@ -201,7 +202,7 @@ int merge(
 }
 
 
-// apply greedy heuristics to find a maximal number of items in one bin
+// apply greedy heuristics to find a maximal number of items in one bin, the candidates are evaluated block by block by the kernel
 int greedy_heuristic(
    vector<SCIP_Real> & mus, // mus 
    vector<SCIP_Real> & bs, // bs
@@ -210,7 +211,15 @@ int greedy_heuristic(
     int numitems, // the number of items
     conflict_graph & conflict // conflict
 ){
-   vector<short>  status(numitems, -1);
+   int padded = kernel_padded_size(numitems);
+   aligned_reals soa_mus(padded, 0), soa_bs(padded, 0);
+   copy(mus.begin(), mus.begin() + numitems, soa_mus.begin());
+   copy(bs.begin(), bs.begin() + numitems, soa_bs.begin());
+   vector<uint64_t> eligible((padded + 63) / 64, 0); // unknown items
+   for(int item = 0; item < numitems; item++){
+      eligible[item / 64] |= uint64_t(1) << (item % 64);
+   }
+   alignas(KERNEL_ALIGN) SCIP_Real cap_use[KERNEL_WIDTH];
 	SCIP_Real sumb = 0;
 	SCIP_Real summu = 0;
 	SCIP_Real lhs = 0;
@@ -218,29 +227,27 @@ int greedy_heuristic(
    while(true){
 		SCIP_Real best_use = capacity + 1;
 		int candidate = -1;
-      for(int item = 0; item < numitems; item++){
-         if( status[item] != -1){
+      for(int p0 = 0; p0 < padded; p0 += KERNEL_WIDTH){
+         unsigned block = kernel_block_bits(eligible, p0);
+         if(block == 0){
             continue;
          }
-         SCIP_Real lhs_ = summu + mus[item] + Dalpha * sqrt(sumb + bs[item]);
-         if(lhs_ > capacity){
-            status[item] = 0;
-            continue;
-         }
-         SCIP_Real cap_use = lhs_ - lhs;
-         if(cap_use < best_use){
-            best_use = cap_use;
-				candidate = item;
+         unsigned fit = conic_kernel(&soa_mus[p0], &soa_bs[p0], NULL, block, summu, sumb, lhs, Dalpha, capacity, cap_use, NULL);
+         kernel_clear_block_bits(eligible, p0, block & ~fit); // not packable anymore
+         for(; fit != 0; fit &= fit - 1){
+            int lane = __builtin_ctz(fit);
+            if(cap_use[lane] < best_use){
+               best_use = cap_use[lane];
+               candidate = p0 + lane;
+            }
          }
       }
       if(candidate != -1){
          summu += mus[candidate];
          sumb += bs[candidate];
          lhs = summu + Dalpha * sqrt(sumb);
-         for(int item_: conflict.get_diffs(candidate)){ // fixed by conflict
-            status[item_] = 0;
-         }
-         status[candidate] = 1;
+         conflict.clear_diffs(candidate, eligible); // fixed by conflict
+         eligible[candidate / 64] &= ~(uint64_t(1) << (candidate % 64));
          bin_size++;
       }
       else{
@@ -249,6 +256,48 @@ int greedy_heuristic(
    }
    return bin_size;
 }
+// keep the columns of the new items of the last pricing rounds at the current node, the newest first
+void update_warm_pool(
+   list<vector<int>> & warm_pool, // columns of the last pricing rounds
+   const list<list<int>> & new_sol_pool, // columns of this pricing round
+   int warm_pool_size // the maximal number of columns kept
+){
+   for(auto it = new_sol_pool.rbegin(); it != new_sol_pool.rend(); it++){
+      vector<int> column(it->begin(), it->end());
+      sort(column.begin(), column.end());
+      warm_pool.remove(column);
+      warm_pool.push_front(column);
+   }
+   while(int(warm_pool.size()) > warm_pool_size){
+      warm_pool.pop_back();
+   }
+}
+
+
+// collect the SOC cuts found by the pricing models in the cut pool, and select the cuts of the pool for the models of a new node
+void update_cut_pool(
+   ProbDataCBP * probdata, // problem data
+   pricing_model & pr_model, // the pricing models
+   const vector<int> & belongs, // items corresponding to the to new items
+   const vector<vector<int>> & new_items, // new items that contains the original items
+   const vector<SCIP_Real> & new_mus, // new items' mus
+   const vector<SCIP_Real> & new_bs, // new items' bs
+   int num_new_items, // the number of new items
+   bool is_new_node // the models are built for a new node
+){
+   if(probdata->algo_conf.cut_pool_size <= 0){
+      return;
+   }
+   if(is_new_node){
+      probdata->cut_pool->select(belongs, new_mus, probdata->capacity, num_new_items, CUT_POOL_MAX_SELECT, pr_model.rel.init_cuts);
+   }
+   else{
+      probdata->cut_pool->add(pr_model.rel.found_cuts, new_items, probdata->bs, new_bs);
+      pr_model.rel.found_cuts.clear();
+   }
+}
+
+
 // solve the pricing problem
 void solve_pricing(
 	SCIP * scip, /** scip pointer */
@@ -286,6 +335,9 @@ void solve_pricing(
       vector<int> new_items_bin;
       vector<pair<int,int>> new_same(0);
       conflict_graph conflict = conflict_graph(num_new_items, new_differ);
+      dominance_index dominance = dominance_index(new_mus, new_bs, num_new_items);
+      pricing_model pr_model; // models of the diving node
+      update_cut_pool(probdata, pr_model, belongs, new_items, new_mus, new_bs, num_new_items, true);
 
       // construct initial quadratic estimator
       int full_piece_size = greedy_heuristic(new_mus,  new_bs, probdata->Dalpha, probdata->capacity,  num_new_items,  conflict); // compute the piece size
@@ -298,8 +350,9 @@ void solve_pricing(
 
       list<list<int>> new_sol_pool;
       solve_conic_knap(scip, probdata->stat_pr, new_objs, new_mus, new_bs,   probdata->Dalpha, probdata->capacity, num_new_items,  init_estimator,
-      new_same,  new_differ, conflict,  probdata->algo_conf, new_sol_pool,  sol_val,  sol_ub, sol_type,   stop_pricing_obj, 
+      new_same, conflict, dominance, pr_model, list<vector<int>>(), probdata->algo_conf, new_sol_pool,  sol_val,  sol_ub, sol_type,   stop_pricing_obj, 
          cbp_time < timelimit?  cbp_time : timelimit, target_bd);
+      update_cut_pool(probdata, pr_model, belongs, new_items, new_mus, new_bs, num_new_items, false);
       for(auto it =  new_sol_pool.begin(); it != new_sol_pool.end(); it++){
          sol_pool.push_back(vector<int>());
          vector<int> & items_bin = sol_pool.back();
@@ -327,6 +380,9 @@ void solve_pricing(
       vector<int> new_items_bin;
       vector<pair<int,int>> new_same(0);
       probdata->conflict = conflict_graph(probdata->num_new_items, probdata->new_differ);
+      probdata->dominance = dominance_index(probdata->new_mus, probdata->new_bs, probdata->num_new_items);
+      probdata->warm_pool.clear();
+      update_cut_pool(probdata, *probdata->pr_model, probdata->belongs, probdata->new_items, probdata->new_mus, probdata->new_bs, probdata->num_new_items, true);
 
       // construct initial quadratic estimator
       probdata->cbp_time = (probdata->num_new_items) * 0.022;
@@ -335,7 +391,7 @@ void solve_pricing(
          probdata->num_new_items,  probdata->conflict) ; // compute the piece size
          SCIP_Real lb_milp = 0, ub_milp = probdata->capacity;
          if(probdata->algo_conf.is_bd_tight){
-            rel_milp_bd( scip, probdata->new_mus, probdata->new_bs,  probdata->Dalpha, probdata->capacity , probdata->num_new_items, probdata->new_differ,  lb_milp,  ub_milp,  max_iter_bd,  rel_eps_bd, timelimit_bd);
+            rel_milp_bd( probdata->new_mus, probdata->new_bs,  probdata->Dalpha, probdata->capacity , probdata->num_new_items, probdata->conflict,  lb_milp,  ub_milp,  max_iter_bd,  rel_eps_bd, timelimit_bd);
          }
          //SCIPdebugMessage("%lf %lf\n", lb_milp, ub_milp);
          int piece_size = ceil((ub_milp - lb_milp) /  probdata->capacity *  full_piece_size);
@@ -347,8 +403,10 @@ void solve_pricing(
 
       list<list<int>> new_sol_pool;
       solve_conic_knap(scip, probdata->stat_pr,  new_objs, probdata->new_mus, probdata->new_bs, probdata->Dalpha, probdata->capacity, probdata->num_new_items, 
-       probdata->init_estimator, new_same,  probdata->new_differ, probdata->conflict,  probdata->algo_conf, new_sol_pool, sol_val, sol_ub, sol_type,   stop_pricing_obj, 
+       probdata->init_estimator, new_same, probdata->conflict, probdata->dominance, *probdata->pr_model, probdata->warm_pool, probdata->algo_conf, new_sol_pool, sol_val, sol_ub, sol_type,   stop_pricing_obj, 
        probdata->cbp_time < timelimit?  probdata->cbp_time : timelimit, target_bd);
+      update_warm_pool(probdata->warm_pool, new_sol_pool, probdata->algo_conf.warm_pool_size);
+      update_cut_pool(probdata, *probdata->pr_model, probdata->belongs, probdata->new_items, probdata->new_mus, probdata->new_bs, probdata->num_new_items, false);
       for(auto it =  new_sol_pool.begin(); it != new_sol_pool.end(); it++){
          sol_pool.push_back(vector<int>());
          vector<int> & items_bin = sol_pool.back();
@@ -370,8 +428,10 @@ void solve_pricing(
       vector<pair<int,int>> new_same(0);
       list<list<int>> new_sol_pool;
       solve_conic_knap(scip, probdata->stat_pr, new_objs, probdata->new_mus, probdata->new_bs,  probdata->Dalpha, probdata->capacity,  probdata->num_new_items, 
-       probdata->init_estimator, new_same,  probdata->new_differ, probdata->conflict, probdata->algo_conf, new_sol_pool, sol_val, sol_ub, sol_type,   stop_pricing_obj, 
+       probdata->init_estimator, new_same, probdata->conflict, probdata->dominance, *probdata->pr_model, probdata->warm_pool, probdata->algo_conf, new_sol_pool, sol_val, sol_ub, sol_type,   stop_pricing_obj, 
         probdata->cbp_time < timelimit?  probdata->cbp_time : timelimit, target_bd);
+      update_warm_pool(probdata->warm_pool, new_sol_pool, probdata->algo_conf.warm_pool_size);
+      update_cut_pool(probdata, *probdata->pr_model, probdata->belongs, probdata->new_items, probdata->new_mus, probdata->new_bs, probdata->num_new_items, false);
       for(auto it =  new_sol_pool.begin(); it != new_sol_pool.end(); it++){
          sol_pool.push_back(vector<int>());
          vector<int> & items_bin = sol_pool.back();
@@ -450,7 +510,8 @@ SCIP_DECL_PRICERREDCOST(PricerConicKnap::scip_redcost)
    SCIP_Real Farley_Bd_Ori =  lp_obj / sol_ub; 
       //SCIPdebugMessage("%lf %lf %lf %lf %lf %lf\n", (Farley_Bd_Ori - lp_obj) / lp_obj , SCIPgetLPObjval(scip), sol_val, sol_ub, stop_pricing_obj, fabs(stop_pricing_obj - sol_ub) / sol_ub );
 
-   if(sol_type == Optimal || sol_type == Feasible_Exact ){
+   // the heuristic pricing rounds with a continuous relaxation bound also have a Farley lower bound
+   if(sol_type == Optimal || sol_type == Feasible_Exact || (sol_type == Feasible_Heur && sol_ub < MAXFLOAT)){
       //SCIPdebugMessage("%lf\n", sol_val);
       (*result) = SCIP_SUCCESS;
       if(SCIPisPositive(scip, sol_val - 1)){ // add the optimal pack
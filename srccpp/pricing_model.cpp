@@ -0,0 +1,341 @@
+/**@file   pricing_model.cpp
+ * @brief  Persistent CPLEX models of the pricing problem
+ * @author Liding Xu
+ *---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+#include <cmath>
+#include <algorithm>
+#include "pricing_model.h"
+
+
+cplex_model::~cplex_model(){
+	for(IloCplex::Callback::Function * cb: callbacks){
+		delete cb;
+	}
+	env.end();
+}
+
+
+/** end the model and its environment, the next pricing round builds it again */
+void cplex_model::clear(){
+	if(!built){
+		return;
+	}
+	for(IloCplex::Callback::Function * cb: callbacks){
+		delete cb;
+	}
+	callbacks.clear();
+	sample_pts.clear();
+	found_cuts.clear();
+	num_refinements = 0;
+	env.end(); // ends the solver, the model and the variables
+	env = IloEnv();
+	numitems = 0;
+	built = false;
+}
+
+
+/** the sorted conflicting pairs of the items */
+static vector<pair<int, int>> conflict_pairs(
+	int numitems, /** number of items */
+	const conflict_graph & conflict /** the conflict graph*/
+){
+	vector<pair<int, int>> pairs;
+	for(int item = 0; item < numitems; item++){
+		for(int item_: conflict.get_diffs(item)){
+			if(item < item_){
+				pairs.push_back(make_pair(item, item_));
+			}
+		}
+	}
+	sort(pairs.begin(), pairs.end());
+	return pairs;
+}
+
+
+/** record the items and the conflicts the model is built over */
+void cplex_model::set_structure(
+	const vector<SCIP_Real> & mus_, /** mu of items */
+	const vector<SCIP_Real> & bs_, /** b of items */
+	SCIP_Real Dalpha_, /** Dalpha */
+	SCIP_Real capacity_, /** capacity */
+	int numitems_, /** number of items */
+	const conflict_graph & conflict /** the conflict graph*/
+){
+	numitems = numitems_;
+	mus.assign(mus_.begin(), mus_.begin() + numitems);
+	bs.assign(bs_.begin(), bs_.begin() + numitems);
+	Dalpha = Dalpha_;
+	capacity = capacity_;
+	diffs = conflict_pairs(numitems, conflict);
+}
+
+
+/** the model is built over these items and conflicts, so only its objective and target row need an update */
+bool cplex_model::same_structure(
+	const vector<SCIP_Real> & mus_, /** mu of items */
+	const vector<SCIP_Real> & bs_, /** b of items */
+	SCIP_Real Dalpha_, /** Dalpha */
+	SCIP_Real capacity_, /** capacity */
+	int numitems_, /** number of items */
+	const conflict_graph & conflict /** the conflict graph*/
+) const{
+	return built && numitems == numitems_ && Dalpha == Dalpha_ && capacity == capacity_
+		&& equal(mus.begin(), mus.end(), mus_.begin()) && equal(bs.begin(), bs.end(), bs_.begin())
+		&& diffs == conflict_pairs(numitems, conflict);
+}
+
+
+/** set the objective coefficients of the items and the target lower bound */
+void cplex_model::update(
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	SCIP_Real target_lb /* the tagret lower bound bound  */
+){
+	IloNumArray coefs(env, numitems);
+	for(int item = 0; item < numitems; item++){
+		coefs[item] = objs[item];
+	}
+	obj.setLinearCoefs(x_vars, coefs);
+	target_row.setLinearCoefs(x_vars, coefs);
+	target_row.setLB(target_lb - tol);
+	coefs.end();
+}
+
+
+/** replace the MIP starts of the solver by the packings with values at least the target lower bound,
+ *   only the item variables are given, CPLEX completes the other variables by solving the fixed problem
+*/
+void cplex_model::set_mip_starts(
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const list<vector<int>> & packings, /** feasible packings, sorted items */
+	SCIP_Real target_lb /* the tagret lower bound bound  */
+){
+	if(cplex.getNMIPStarts() > 0){
+		cplex.deleteMIPStarts(0, cplex.getNMIPStarts());
+	}
+	IloNumArray vals(env, numitems);
+	for(const vector<int> & packing: packings){
+		SCIP_Real val = 0;
+		for(int item: packing){
+			val += objs[item];
+		}
+		if(val < target_lb - tol){
+			continue;
+		}
+		for(int item = 0; item < numitems; item++){
+			vals[item] = 0;
+		}
+		for(int item: packing){
+			vals[item] = 1;
+		}
+		cplex.addMIPStart(x_vars, vals, IloCplex::MIPStartSolveFixed);
+	}
+	vals.end();
+}
+
+
+/** add the improving conic feasible packings of the solution pool of the solver to sol_pool,
+ *   best values first, until sol_pool has max_columns packings
+*/
+void cplex_model::harvest_pool(
+	const vector<SCIP_Real> & objs, /** objective coefficients of items */
+	const vector<SCIP_Real> & mus, /** mu of items */
+	const vector<SCIP_Real> & bs, /** b of items */
+	SCIP_Real Dalpha, /** Dalpha */
+	SCIP_Real capacity, /** capacity */
+	SCIP_Real target_lb, /* the tagret lower bound bound  */
+	int max_columns, /** the maximal number of packings in sol_pool */
+	list<list<int>> & sol_pool /* solutions pools, solution items are assumed to be sorted */
+){
+	int num_sols = cplex.getSolnPoolNsolns();
+	if(int(sol_pool.size()) >= max_columns || num_sols <= 1){
+		return;
+	}
+	vector<pair<SCIP_Real, list<int>>> sols; // (value, items) of the improving conic feasible packings, valued by objs over the rounded items
+	for(int sol = 0; sol < num_sols; sol++){
+		list<int> items_bin;
+		SCIP_Real val = 0, summu = 0, sumb = 0;
+		for(int item = 0; item < numitems; item++){
+			if(IloRound(cplex.getValue(x_vars[item], sol)) == 1){
+				items_bin.push_back(item);
+				val += objs[item];
+				summu += mus[item];
+				sumb += bs[item];
+			}
+		}
+		if(val > target_lb + tol && summu + Dalpha * sqrt(sumb) < capacity + tol){
+			sols.push_back(make_pair(val, items_bin));
+		}
+	}
+	stable_sort(sols.begin(), sols.end(), [](const pair<SCIP_Real, list<int>> & sol1, const pair<SCIP_Real, list<int>> & sol2){ return sol1.first > sol2.first; });
+	for(const pair<SCIP_Real, list<int>> & sol: sols){
+		if(int(sol_pool.size()) >= max_columns){
+			break;
+		}
+		if(find(sol_pool.begin(), sol_pool.end(), sol.second) == sol_pool.end()){
+			sol_pool.push_back(sol.second);
+		}
+	}
+}
+
+
+/** solve the model within time_limit seconds and the budget, the deterministic ticks of the solve are charged to the budget.
+ *   The limits are set at every solve since the solver is kept between the pricing rounds
+*/
+void cplex_model::solve(
+	work_budget & budget, /** the work budget */
+	SCIP_Real time_limit /** solving time left */
+){
+	cplex.setParam(IloCplex::Param::TimeLimit, time_limit);
+	cplex.setParam(IloCplex::Param::DetTimeLimit, budget.is_det() ? max(budget.left(), 0.0) : 1e75);
+	cplex.setParam(IloCplex::Param::Parallel, budget.is_det() ? IloCplex::Deterministic : IloCplex::AutoParallel); // the parallel solves are reproducible
+	SCIP_Real ticks = cplex.getDetTime();
+	aborter.clear();
+	if(race != NULL){
+		race->attach(aborter);
+	}
+	cplex.solve();
+	budget.charge_ticks(cplex.getDetTime() - ticks);
+}
+
+
+/** abort the solve in the global progress context if the incumbent value is above abort_lb and at least abort_ratio times the best bound.
+ *   The incumbents of the models are conic feasible, so the aborted solve returns an improving column with a valid upper bound
+*/
+void cplex_model::abort_at_incumbent(
+	const IloCplex::Callback::Context & context /** the callback context */
+){
+	if(!context.inGlobalProgress() || abort_lb >= MAXFLOAT || !context.getIntInfo(IloCplex::Callback::Context::Info::Feasible)){
+		return;
+	}
+	SCIP_Real val = context.getIncumbentObjective();
+	if(val > abort_lb && val >= abort_ratio * context.getDoubleInfo(IloCplex::Callback::Context::Info::BestBound)){
+		aborted = true;
+		context.abort();
+	}
+}
+
+
+/** add the cuts over the merged items, new_items are the original items of the merged items */
+void soc_cut_pool::add(
+	const vector<soc_cut> & found_cuts, /** cuts over the merged items */
+	const vector<vector<int>> & new_items, /** original items of the merged items */
+	const vector<SCIP_Real> & bs, /** b of the original items */
+	const vector<SCIP_Real> & new_bs /** b of the merged items */
+){
+	for(const soc_cut & found: found_cuts){
+		pool_cut pc;
+		pc.age = 0;
+		for(size_t i = 0; i < found.items.size(); i++){
+			int new_item = found.items[i];
+			if(new_bs[new_item] <= 0){
+				continue;
+			}
+			for(int item: new_items[new_item]){ // the coefficient of the merged item is split by b
+				if(bs[item] > 0){
+					pc.cut.items.push_back(item);
+					pc.cut.coefs.push_back(found.coefs[i] * bs[item] / new_bs[new_item]);
+				}
+			}
+		}
+		if(pc.cut.items.empty()){
+			continue;
+		}
+		vector<int> order(pc.cut.items.size());
+		for(size_t i = 0; i < order.size(); i++){
+			order[i] = i;
+		}
+		sort(order.begin(), order.end(), [&pc](int i1, int i2){ return pc.cut.items[i1] < pc.cut.items[i2]; });
+		soc_cut sorted;
+		for(int i: order){
+			sorted.items.push_back(pc.cut.items[i]);
+			sorted.coefs.push_back(pc.cut.coefs[i]);
+		}
+		pc.cut = sorted;
+		bool duplicate = false;
+		for(const pool_cut & pc_: cuts){
+			if(pc_.cut.items == pc.cut.items){
+				duplicate = true;
+				for(size_t i = 0; i < pc.cut.coefs.size(); i++){
+					if(fabs(pc_.cut.coefs[i] - pc.cut.coefs[i]) > tol){
+						duplicate = false;
+						break;
+					}
+				}
+				if(duplicate){
+					break;
+				}
+			}
+		}
+		if(!duplicate){
+			cuts.push_back(pc);
+		}
+	}
+	while(int(cuts.size()) > max_size){ // remove the oldest cuts
+		auto oldest = cuts.begin();
+		for(auto it = cuts.begin(); it != cuts.end(); it++){
+			if(it->age > oldest->age){
+				oldest = it;
+			}
+		}
+		cuts.erase(oldest);
+	}
+}
+
+
+/** select at most max_cuts cuts by their violations at the packings of their supports over the merged items, the cuts are mapped to the merged items.
+ *   The cuts not violated at their supports do not cut any packing of their supports at this node and are not selected.
+*/
+void soc_cut_pool::select(
+	const vector<int> & belongs, /** merged items of the original items */
+	const vector<SCIP_Real> & new_mus, /** mu of the merged items */
+	SCIP_Real capacity, /** capacity */
+	int num_new_items, /** number of merged items */
+	int max_cuts, /** maximal number of selected cuts */
+	vector<soc_cut> & selected /** selected cuts over the merged items */
+){
+	selected.clear();
+	vector<SCIP_Real> coefs(num_new_items, 0);
+	vector<pair<SCIP_Real, list<pool_cut>::iterator>> violated; // violations of the cuts at their supports
+	vector<soc_cut> mapped; // the cuts over the merged items
+	for(auto it = cuts.begin(); it != cuts.end(); it++){
+		it->age++;
+		soc_cut cut;
+		for(size_t i = 0; i < it->cut.items.size(); i++){
+			int new_item = belongs[it->cut.items[i]];
+			if(coefs[new_item] == 0){
+				cut.items.push_back(new_item);
+			}
+			coefs[new_item] += it->cut.coefs[i];
+		}
+		SCIP_Real lhs = 0;
+		for(int new_item: cut.items){
+			lhs += new_mus[new_item] + coefs[new_item];
+			cut.coefs.push_back(coefs[new_item]);
+			coefs[new_item] = 0;
+		}
+		if(lhs > capacity + tol){
+			violated.push_back(make_pair(lhs - capacity, it));
+			mapped.push_back(cut);
+		}
+	}
+	vector<int> order(violated.size());
+	for(size_t i = 0; i < order.size(); i++){
+		order[i] = i;
+	}
+	sort(order.begin(), order.end(), [&violated](int i1, int i2){ return violated[i1].first > violated[i2].first; });
+	for(int i: order){
+		if(int(selected.size()) >= max_cuts){
+			break;
+		}
+		violated[i].second->age = 0;
+		selected.push_back(mapped[i]);
+	}
+	for(auto it = cuts.begin(); it != cuts.end();){ // remove the old cuts
+		if(it->age > CUT_POOL_MAX_AGE){
+			it = cuts.erase(it);
+		}
+		else{
+			it++;
+		}
+	}
+}
@@ -0,0 +1,239 @@
+/**@file   pricing_model.h
+ * @brief  Persistent CPLEX models of the pricing problem
+ * @author Liding Xu
+ *---+----1----+----2----+----3----+----4----+----5----+----6----+----7----+----8----+----9----+----0----+----1----+----2*/
+#pragma once
+#include <vector>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <cmath>
+#include <ilcplex/ilocplex.h>
+#include "utilities.h"
+using namespace std;
+
+#define PWL_MAX_REFINEMENTS 16 /* maximal number of breakpoint refinements added to a relaxation model before it is rebuilt */
+#define CUT_POOL_MAX_AGE 50 /* maximal number of cut selections of the cut pool that a cut survives without being selected */
+#define CUT_POOL_MAX_SELECT 200 /* maximal number of the cuts of the cut pool added to a new relaxation model */
+
+
+/* the race of the pricing algorithms of a portfolio round, the first algorithm deciding the round wins it.
+ *  The other algorithms are cancelled cooperatively: the combinatorial ones check the cancel flag of their budgets,
+ *  and the solves of CPLEX are stopped by their aborters.
+*/
+class pricing_race{
+	mutex aborters_mutex; // guards aborters
+	vector<IloCplex::Aborter> aborters; // aborters of the solves of the race
+public:
+	atomic<bool> decided; // the round is decided, the cancel flag of the budgets
+	atomic<int> winner; // the algorithm deciding the round, -1: none
+
+	pricing_race(): decided(false), winner(-1){};
+
+	/** the algorithm decides the round, returns false if another algorithm decided it before, the other algorithms are cancelled */
+	bool decide(
+		int algo /** the algorithm */
+	){
+		int none = -1;
+		if(!winner.compare_exchange_strong(none, algo)){
+			return false;
+		}
+		lock_guard<mutex> lock(aborters_mutex);
+		decided = true;
+		for(IloCplex::Aborter & aborter: aborters){
+			aborter.abort();
+		}
+		return true;
+	};
+
+	/** add the aborter of a solve starting in the race, it aborts at once if the round is already decided */
+	void attach(
+		IloCplex::Aborter aborter /** the cleared aborter of the solver */
+	){
+		lock_guard<mutex> lock(aborters_mutex);
+		aborters.push_back(aborter);
+		if(decided){
+			aborter.abort();
+		}
+	};
+};
+
+
+/* a sparse outer approximation cut of the SOC constraint at a point x_, where mu is the mu variable of the model:
+ *   mu + Dalpha (\sum_i b_s[i] x_[i] x_s[i]) / sqrt{\sum_i bs[i] x_[i]^2} <= capacity,
+ *   it is valid for the packings, since bs^t x_s = ||diag(sqrt{bs}) x_s||^2 for binary x_s and the norm is above its tangents,
+ *   the terms are the items with x_[i] > 0
+*/
+struct soc_cut{
+	vector<int> items; /** items of the terms */
+	vector<SCIP_Real> coefs; /** coefficients of the terms */
+};
+
+
+/* a CPLEX model of the pricing problem over fixed items, the objective and the target row change between the pricing rounds,
+ *  the breakpoints of the piecewise linear relaxation are refined in place */
+class cplex_model{
+public:
+	IloEnv env; // environment owning the model
+	IloModel model; // the model
+	IloCplex cplex; // the solver with the extracted model
+	IloNumVarArray x_vars; // binary variables of the items
+	IloObjective obj; // the maximization objective
+	IloRange target_row; // objective >= target lower bound
+	IloNumVar mu_var; // mu of the packing in the piecewise linear relaxation
+	IloNumVar b_var; // Dalpha^2 b of the packing in the piecewise linear relaxation
+	vector<pair<SCIP_Real, SCIP_Real>> sample_pts; // breakpoints of the piecewise linear relaxation, empty for the MISOCP
+	int num_refinements; // number of breakpoint refinements added to the model
+	vector<IloCplex::Callback::Function *> callbacks; // callbacks used by the solver
+	IloCplex::Aborter aborter; // stops the solves of a pricing race from the other threads
+	pricing_race * race; // the race of the solves, NULL: no race
+	int num_threads; // threads of the solves if CPLEX is parallel, 0: all the cores
+	vector<SCIP_Real> mus, bs; // mu and b of the items, read by the callbacks
+	SCIP_Real Dalpha, capacity; // Dalpha and capacity of the model
+	vector<pair<int, int>> diffs; // sorted conflicting pairs of the items, with mus, bs, Dalpha and capacity they are the structure of the model
+	vector<soc_cut> init_cuts; // cuts of the cut pool added when the relaxation model is built
+	vector<soc_cut> found_cuts; // cuts of the rejected candidates found by the callbacks, collected by the cut pool
+	mutex found_mutex; // guards found_cuts in the parallel callbacks
+	SCIP_Real abort_lb; // the solve is aborted at an incumbent above abort_lb with at least abort_ratio of the best bound, MAXFLOAT: never
+	SCIP_Real abort_ratio;
+	atomic<bool> aborted; // the last solve was aborted at an incumbent
+	int numitems; // number of items
+	bool built; // the model is built
+
+	cplex_model(): num_refinements(0), race(NULL), num_threads(0), Dalpha(0), capacity(0), abort_lb(MAXFLOAT), abort_ratio(1), aborted(false), numitems(0), built(false){};
+
+	~cplex_model();
+
+	/** end the model and its environment, the next pricing round builds it again */
+	void clear();
+
+	/** record the items and the conflicts the model is built over */
+	void set_structure(
+		const vector<SCIP_Real> & mus_, /** mu of items */
+		const vector<SCIP_Real> & bs_, /** b of items */
+		SCIP_Real Dalpha_, /** Dalpha */
+		SCIP_Real capacity_, /** capacity */
+		int numitems_, /** number of items */
+		const conflict_graph & conflict /** the conflict graph*/
+	);
+
+	/** the model is built over these items and conflicts, so only its objective and target row need an update */
+	bool same_structure(
+		const vector<SCIP_Real> & mus_, /** mu of items */
+		const vector<SCIP_Real> & bs_, /** b of items */
+		SCIP_Real Dalpha_, /** Dalpha */
+		SCIP_Real capacity_, /** capacity */
+		int numitems_, /** number of items */
+		const conflict_graph & conflict /** the conflict graph*/
+	) const;
+
+	/** set the objective coefficients of the items and the target lower bound */
+	void update(
+		const vector<SCIP_Real> & objs, /** objective coefficients of items */
+		SCIP_Real target_lb /* the tagret lower bound bound  */
+	);
+
+	/** replace the MIP starts of the solver by the packings with values at least the target lower bound */
+	void set_mip_starts(
+		const vector<SCIP_Real> & objs, /** objective coefficients of items */
+		const list<vector<int>> & packings, /** feasible packings, sorted items */
+		SCIP_Real target_lb /* the tagret lower bound bound  */
+	);
+
+	/** add the improving conic feasible packings of the solution pool of the solver to sol_pool,
+	 *   best values first, until sol_pool has max_columns packings
+	*/
+	void harvest_pool(
+		const vector<SCIP_Real> & objs, /** objective coefficients of items */
+		const vector<SCIP_Real> & mus, /** mu of items */
+		const vector<SCIP_Real> & bs, /** b of items */
+		SCIP_Real Dalpha, /** Dalpha */
+		SCIP_Real capacity, /** capacity */
+		SCIP_Real target_lb, /* the tagret lower bound bound  */
+		int max_columns, /** the maximal number of packings in sol_pool */
+		list<list<int>> & sol_pool /* solutions pools, solution items are assumed to be sorted */
+	);
+
+	/** solve the model within time_limit seconds and the budget, the deterministic ticks of the solve are charged to the budget,
+	 *   the solve joins the race if there is one */
+	void solve(
+		work_budget & budget, /** the work budget */
+		SCIP_Real time_limit /** solving time left */
+	);
+
+	/** abort the solve in the global progress context if the incumbent is good enough for the column generation */
+	void abort_at_incumbent(
+		const IloCplex::Callback::Context & context /** the callback context */
+	);
+
+private:
+	cplex_model(const cplex_model &);
+	cplex_model & operator=(const cplex_model &);
+};
+
+
+/* a generic callback of the MISOCP model, it only aborts the solve at the good incumbents */
+class AbortCallback: public IloCplex::Callback::Function{
+public:
+	cplex_model & model; // the model of the solver
+
+	AbortCallback(cplex_model & model_): model(model_){};
+
+	virtual void invoke(const IloCplex::Callback::Context & context) ILO_OVERRIDE{
+		model.abort_at_incumbent(context);
+	};
+
+	virtual ~AbortCallback(){};
+};
+
+
+/* a pool of the SOC outer approximation cuts over the original items. The cuts do not depend on the duals,
+ *  and the cut of a packing of the merged items is a cut of the original items after splitting the coefficients by b,
+ *  so the cuts are valid at every node. The cuts not selected in CUT_POOL_MAX_AGE selections are removed,
+ *  and the oldest cuts are removed if the pool is full.
+*/
+class soc_cut_pool{
+public:
+	struct pool_cut{
+		soc_cut cut; // the cut over the original items
+		int age; // number of selections since the cut was found or last selected
+	};
+	list<pool_cut> cuts; // cuts of the pool
+	int max_size; // maximal number of cuts
+
+	soc_cut_pool(int max_size_ = 0): max_size(max_size_){};
+
+	/** add the cuts over the merged items, new_items are the original items of the merged items */
+	void add(
+		const vector<soc_cut> & found_cuts, /** cuts over the merged items */
+		const vector<vector<int>> & new_items, /** original items of the merged items */
+		const vector<SCIP_Real> & bs, /** b of the original items */
+		const vector<SCIP_Real> & new_bs /** b of the merged items */
+	);
+
+	/** select at most max_cuts cuts by their violations at the packings of their supports over the merged items, the cuts are mapped to the merged items.
+	 *   The cuts not violated at their supports do not cut any packing of their supports at this node and are not selected.
+	*/
+	void select(
+		const vector<int> & belongs, /** merged items of the original items */
+		const vector<SCIP_Real> & new_mus, /** mu of the merged items */
+		SCIP_Real capacity, /** capacity */
+		int num_new_items, /** number of merged items */
+		int max_cuts, /** maximal number of selected cuts */
+		vector<soc_cut> & selected /** selected cuts over the merged items */
+	);
+};
+
+
+/* the CPLEX pricing models of a node, they are built again when the merged items or their conflicts change */
+class pricing_model{
+public:
+	cplex_model micp; // MISOCP model
+	cplex_model rel; // piecewise linear relaxation model
+
+	/** clear the models */
+	inline void clear(){
+		micp.clear();
+		rel.clear();
+	};
+};
@@ -24,6 +24,7 @@
 #include <queue>        
 
 #include "probdata_cbp.h"
+#include "pricing_model.h"
 #include "objscip/objscip.h"
 #include "scip/struct_cons.h"
 #include "scip/cons_linear.h"
@@ -84,7 +85,8 @@ SCIP_DECL_VARDELTRANS(vardataDelTrans)
 /** ProbDataCBP destructor */
 ProbDataCBP::~ProbDataCBP()
 {
-
+	delete pr_model;
+	delete cut_pool;
 }
 
 
@@ -161,6 +163,8 @@ SCIP_RETCODE ProbDataCBP::scip_trans(
 	transprobdata->global_lb = -SCIPinfinity(scip);
 	transprobdata->stat_pr = stat_pr;
 	transprobdata->algo_conf = algo_conf;
+	transprobdata->pr_model = new pricing_model();
+	transprobdata->cut_pool = new soc_cut_pool(algo_conf.cut_pool_size);
 	SCIPdebugMessage("transformed data check!");
 	// transform and cpature transformed set partition constraints
 	for (int i = 0; i < sc_conss.size(); i++) {
@@ -35,6 +35,9 @@
 using namespace scip;
 using namespace std;
 
+class pricing_model;
+class soc_cut_pool;
+
 
 
 /** Packing variable class */
@@ -96,7 +99,7 @@ public:
       const vector<SCIP_Real> & mus_, /**< mus */
 		const vector<SCIP_Real> & bs_ /**< bs */
       )
-      : numitems(numitems_), capacity(capacity_), Dalpha(Dalpha_), mus(mus_), bs(bs_){}
+      : pr_model(NULL), cut_pool(NULL), numitems(numitems_), capacity(capacity_), Dalpha(Dalpha_), mus(mus_), bs(bs_){}
 
    /**< destructor */
    ~ProbDataCBP();
@@ -191,6 +194,10 @@ public:
    SCIP_Real cbp_time; // pricing cbp time limit
    SCIP_Real global_lb; // global lower bound
    conflict_graph conflict; // conflict graph
+   dominance_index dominance; // dominance index of the new items
+   list<vector<int>> warm_pool; // columns of the new items of the last pricing rounds at the current node
+   pricing_model * pr_model; // persistent CPLEX pricing models of the new items at the current node
+   soc_cut_pool * cut_pool; // SOC cuts over the items found by the pricing, valid at every node
    conf algo_conf; // algorithm configuration
    stat stat_pr; // statistics pricing
 
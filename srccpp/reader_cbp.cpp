@@ -131,6 +131,30 @@ SCIP_DECL_READERREAD(ReaderCBP::scip_read) {
 	SCIP_CALL(SCIPgetIntParam(scip,  "cbp/knn_mode", &problemdata->algo_conf.knn_mode));
 	SCIP_CALL(SCIPgetIntParam(scip,  "cbp/kneighbors", &problemdata->algo_conf.kneighbors));
 	SCIP_CALL(SCIPgetRealParam(scip,  "cbp/point_ratio", &problemdata->algo_conf.point_ratio));
+	SCIP_CALL(SCIPgetIntParam(scip,  "cbp/heur_threads", &problemdata->algo_conf.heur_threads));
+	SCIP_CALL(SCIPgetIntParam(scip,  "cbp/heur_columns", &problemdata->algo_conf.heur_columns));
+	SCIP_CALL(SCIPgetRealParam(scip,  "cbp/heur_jaccard", &problemdata->algo_conf.heur_jaccard));
+	SCIP_CALL(SCIPgetBoolParam(scip,  "cbp/is_local_search", &problemdata->algo_conf.is_local_search));
+	SCIP_CALL(SCIPgetIntParam(scip,  "cbp/grasp_iters", &problemdata->algo_conf.grasp_iters));
+	SCIP_CALL(SCIPgetRealParam(scip,  "cbp/grasp_alpha", &problemdata->algo_conf.grasp_alpha));
+	SCIP_CALL(SCIPgetIntParam(scip,  "cbp/grasp_seed", &problemdata->algo_conf.grasp_seed));
+	SCIP_CALL(SCIPgetIntParam(scip,  "cbp/warm_pool_size", &problemdata->algo_conf.warm_pool_size));
+	SCIP_CALL(SCIPgetBoolParam(scip,  "cbp/is_dp", &problemdata->algo_conf.is_dp));
+	SCIP_CALL(SCIPgetRealParam(scip,  "cbp/dp_eps", &problemdata->algo_conf.dp_eps));
+	SCIP_CALL(SCIPgetIntParam(scip,  "cbp/dp_max_items", &problemdata->algo_conf.dp_max_items));
+	SCIP_CALL(SCIPgetIntParam(scip,  "cbp/bb_max_items", &problemdata->algo_conf.bb_max_items));
+	SCIP_CALL(SCIPgetBoolParam(scip,  "cbp/is_rel_bound", &problemdata->algo_conf.is_rel_bound));
+	SCIP_CALL(SCIPgetIntParam(scip,  "cbp/exact_columns", &problemdata->algo_conf.exact_columns));
+	SCIP_CALL(SCIPgetRealParam(scip,  "cbp/exact_abort_ratio", &problemdata->algo_conf.exact_abort_ratio));
+	SCIP_CALL(SCIPgetIntParam(scip,  "cbp/pwl_formulation", &problemdata->algo_conf.pwl_formulation));
+	char * pricing_record;
+	SCIP_CALL(SCIPgetStringParam(scip,  "cbp/pricing_record", &pricing_record));
+	problemdata->algo_conf.pricing_record = pricing_record;
+	SCIP_CALL(SCIPgetBoolParam(scip,  "cbp/is_soc_usercut", &problemdata->algo_conf.is_soc_usercut));
+	SCIP_CALL(SCIPgetIntParam(scip,  "cbp/cut_pool_size", &problemdata->algo_conf.cut_pool_size));
+	SCIP_CALL(SCIPgetBoolParam(scip,  "cbp/is_mip_start", &problemdata->algo_conf.is_mip_start));
+	SCIP_CALL(SCIPgetRealParam(scip,  "cbp/work_rate", &problemdata->algo_conf.work_rate));
+	SCIP_CALL(SCIPgetIntParam(scip,  "cbp/portfolio", &problemdata->algo_conf.portfolio));
 	SCIP_CALL(SCIPcreateObjProb(scip, filename, problemdata, FALSE));
 
 	SCIPdebugMessage("objprob created and creating inital solutions!\n");
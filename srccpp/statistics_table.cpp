@@ -36,5 +36,22 @@ SCIP_DECL_TABLEOUTPUT(StatisticsTable::scip_output){
     SCIPinfoMessage(scip, file, "pricing avg gap: %lf\n", shf_avg_gap); 
     SCIPinfoMessage(scip, file, "pricing first time:  %lf\n", probdata->stat_pr.cum_sol_time);  
     SCIPinfoMessage(scip, file, "pricing knn time: %lf\n", probdata->stat_pr.cum_knn_time);     
+    SCIPinfoMessage(scip, file, "pricing mu tracking nodes: %lld\n", probdata->stat_pr.num_mu_track);
+    SCIPinfoMessage(scip, file, "pricing mu tracking time: %lf\n", probdata->stat_pr.time_mu_track);
+    SCIPinfoMessage(scip, file, "pricing column dp: %d\n", probdata->stat_pr.col_dp);
+    SCIPinfoMessage(scip, file, "pricing dp time: %lf\n", probdata->stat_pr.time_dp);
+    SCIPinfoMessage(scip, file, "pricing column bb: %d\n", probdata->stat_pr.col_bb);
+    SCIPinfoMessage(scip, file, "pricing bb time: %lf\n", probdata->stat_pr.time_bb);
+    SCIPinfoMessage(scip, file, "pricing column bound: %d\n", probdata->stat_pr.col_bound);
+    SCIPinfoMessage(scip, file, "pricing bound time: %lf\n", probdata->stat_pr.time_bound);
+    SCIPinfoMessage(scip, file, "pricing column abort: %d\n", probdata->stat_pr.col_abort);
+    SCIPinfoMessage(scip, file, "pricing heur work: %lf\n", probdata->stat_pr.work_heur);
+    SCIPinfoMessage(scip, file, "pricing dp work: %lf\n", probdata->stat_pr.work_dp);
+    SCIPinfoMessage(scip, file, "pricing bb work: %lf\n", probdata->stat_pr.work_bb);
+    SCIPinfoMessage(scip, file, "pricing exact work: %lf\n", probdata->stat_pr.work_exact);
+    SCIPinfoMessage(scip, file, "pricing race heur: %d\n", probdata->stat_pr.race_heur);
+    SCIPinfoMessage(scip, file, "pricing race pwlbc: %d\n", probdata->stat_pr.race_pwlbc);
+    SCIPinfoMessage(scip, file, "pricing race micp: %d\n", probdata->stat_pr.race_micp);
+    SCIPinfoMessage(scip, file, "pricing race none: %d\n", probdata->stat_pr.race_none);
     return SCIP_OKAY;
 }
\ No newline at end of file
@@ -5,6 +5,12 @@
 #pragma once
 #include <vector>
 #include <list> 
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <string>
+#include <atomic>
+#include <chrono>
 #include "scip/scip.h"
 
 
@@ -12,6 +18,7 @@ using namespace std;
 #ifndef tol
 #define tol 1e-6
 #endif
+#define WORK_UNIT_STEPS 10000 /* steps of the combinatorial pricing algorithms in a deterministic work unit, a step is about one evaluation of an item */
 
 /* type of solution of conic knapsack problem */
 enum SolType
@@ -31,10 +38,21 @@ struct stat
 {
    SCIP_Real time_heur = 0, time_exact = 0;
    int col_heur = 0,    col_exact = 0;
+   SCIP_Real time_dp = 0;
+   int col_dp = 0;
+   SCIP_Real time_bb = 0;
+   int col_bb = 0;
+   SCIP_Real time_bound = 0;
+   int col_bound = 0;
+   int col_abort = 0;
    SCIP_Real shf_param = 1;
    SCIP_Real shf_log_sum_gap = 0;
    SCIP_Real cum_sol_time = 0;
    SCIP_Real cum_knn_time = 0;
+   long long num_mu_track = 0;
+   SCIP_Real time_mu_track = 0;
+   SCIP_Real work_heur = 0, work_dp = 0, work_bb = 0, work_exact = 0; // work units used by the pricing algorithms
+   int race_heur = 0, race_pwlbc = 0, race_micp = 0, race_none = 0; // rounds of the pricing portfolio decided by the algorithms, or by none
 };
 
 
@@ -49,29 +67,288 @@ struct conf
    int knn_mode = 1; // the mode of knn regression for learning breakpoints, 1: no knn search/learning, 2: uniformly weighted knn, 3: distance weighted knn. default: 1
    int kneighbors = 1; // the number neighbors of knn regression (k). default: 1
    SCIP_Real point_ratio = 1; // the concentration ratio of breakpoints. default: 1 (no knn search)
+   int heur_threads = 1; // the number of threads of the multi-start heuristic pricing. default: 1
+   int heur_columns = 1; // the maximal number of columns of the heuristic pricing. default: 1
+   SCIP_Real heur_jaccard = 0.5; // the maximal Jaccard similarity between two columns of the heuristic pricing. default: 0.5
+   SCIP_Bool is_local_search = true; // improve the heuristic pricing solution by local search? default: true
+   int grasp_iters = 0; // the maximal number of iterations of the GRASP heuristic pricing, 0: disabled. default: 0
+   SCIP_Real grasp_alpha = 0.2; // the restricted candidate list parameter of the GRASP heuristic pricing. default: 0.2
+   int grasp_seed = 0; // the random seed of the GRASP heuristic pricing. default: 0
+   int warm_pool_size = 0; // the number of columns of the last pricing rounds at the same node used as seeds of the heuristic pricing. default: 0
+   SCIP_Bool is_dp = false; // solve the pricing problems without conflicts by the profit scaling dynamic programming first? default: false
+   SCIP_Real dp_eps = 0.05; // the approximation ratio of the dynamic programming. default: 0.05
+   int dp_max_items = 100; // the maximal number of items of the dynamic programming. default: 100
+   int bb_max_items = 0; // the maximal number of items of the pricing problems solved by the combinatorial branch and bound, 0: disabled. default: 0
+   SCIP_Bool is_rel_bound = true; // stop the pricing if the continuous relaxation bound is not improving? default: true
+   int exact_columns = 1; // the maximal number of columns of the exact pricing harvested from the CPLEX solution pool. default: 1
+   SCIP_Real exact_abort_ratio = 1; // the exact pricing stops at an incumbent above the early stopping value with at least this ratio of the best bound, 1: disabled. default: 1
+   int pwl_formulation = 1; // the formulation of the piecewise linear relaxation of the PWLBC, 1: CPLEX piecewise linear, 2: SOS2, 3: incremental, 4: multi-choice. default: 1
+   string pricing_record = ""; // the file where the pricing problems solved by the PWLBC are appended, empty: disabled. default: ""
+   SCIP_Bool is_soc_usercut = true; // separate the SOC constraint at the fractional relaxation points of the PWLBC by user cuts? default: true
+   int cut_pool_size = 1000; // the maximal number of SOC cuts kept in the cut pool and reused by the later PWLBC models, 0: disabled. default: 1000
+   SCIP_Bool is_mip_start = true; // pass the heuristic and the last rounds' packings to the exact pricing as MIP starts? default: true
+   SCIP_Real work_rate = 0; // the pricing budgets are deterministic, work units per second of the time budgets, 0: CPU time budgets. default: 0
+   int portfolio = 0; // race the heuristic and the exact pricing on threads, 0: disabled, 1: with the exact algorithm of is_misocp, 2: with the PWLBC and the MISOCP. default: 0
 };
 
-/* conflict graph */
+
+/* a budget of a pricing algorithm. If it is deterministic, the algorithm stops after work_limit work units,
+ * a work unit is WORK_UNIT_STEPS steps of the combinatorial algorithms or a CPLEX deterministic tick,
+ * otherwise it stops after its time limit. The work is counted in both cases, the steps and the ticks are charged atomically by the threads.
+ * The budget is also exhausted once its cancel flag is set, the flag is set by another thread to stop the algorithm cooperatively.
+*/
+class work_budget{
+	atomic<long long> steps; // charged steps
+	atomic<SCIP_Real> ticks; // charged CPLEX deterministic ticks
+	const atomic<bool> * cancel; // cancel flag, NULL: never cancelled
+public:
+	const SCIP_Real work_limit; // maximal number of work units, infinity: the time limit applies
+
+	explicit work_budget(
+		SCIP_Real work_limit_ = numeric_limits<SCIP_Real>::infinity(), /** maximal number of work units */
+		const atomic<bool> * cancel_ = NULL /** cancel flag */
+	): steps(0), ticks(0), cancel(cancel_), work_limit(work_limit_){};
+
+	/* the algorithm is cancelled */
+	bool is_cancelled() const{
+		return cancel != NULL && cancel->load(memory_order_relaxed);
+	}
+
+	/* the budget is deterministic */
+	bool is_det() const{
+		return work_limit < numeric_limits<SCIP_Real>::infinity();
+	}
+
+	/* charge steps of a combinatorial algorithm */
+	void charge(long long num_steps){
+		steps.fetch_add(num_steps, memory_order_relaxed);
+	}
+
+	/* charge CPLEX deterministic ticks */
+	void charge_ticks(SCIP_Real num_ticks){
+		SCIP_Real old_ticks = ticks.load(memory_order_relaxed);
+		while(!ticks.compare_exchange_weak(old_ticks, old_ticks + num_ticks, memory_order_relaxed)){}
+	}
+
+	/* the work units used */
+	SCIP_Real used() const{
+		return SCIP_Real(steps.load(memory_order_relaxed)) / WORK_UNIT_STEPS + ticks.load(memory_order_relaxed);
+	}
+
+	/* the work units left */
+	SCIP_Real left() const{
+		return work_limit - used();
+	}
+
+	/* the budget is exhausted: it is cancelled, or the work limit is reached if it is deterministic, time_limit seconds passed since start otherwise */
+	bool exhausted(
+		chrono::steady_clock::time_point start, /** the start time of the algorithm */
+		SCIP_Real time_limit /** solving time left after start */
+	) const{
+		if(is_cancelled()){
+			return true;
+		}
+		if(is_det()){
+			return used() >= work_limit;
+		}
+		return chrono::duration<SCIP_Real>(chrono::steady_clock::now() - start).count() >= time_limit;
+	}
+};
+
+/* conflict graph, the neighbours of the items are stored contiguously in CSR arrays.
+ * The items with more neighbours than the words of a bitset over the items also have a bitset row,
+ * so clearing their neighbours in a bitset is a word-wide AND-NOT instead of one bit per neighbour.
+*/
 class conflict_graph{
-	int numitems;
-	vector<list<int>> conflict_list;
+	int numitems = 0;
+	int numwords = 0; // number of words of a bitset over the items
+	vector<int> offsets; // the neighbours of item are adjacency[offsets[item]], ..., adjacency[offsets[item + 1] - 1]
+	vector<int> adjacency;
+	vector<int> row_index; // row of the item in rows, -1 if the item has no bitset row
+	vector<uint64_t> rows; // bitset rows of the neighbours
+
+	void build_rows(){
+		numwords = (numitems + 63) / 64;
+		row_index.assign(numitems, -1);
+		rows.clear();
+		int numrows = 0;
+		for(int item = 0; item < numitems; item++){
+			if(offsets[item + 1] - offsets[item] <= numwords){
+				continue;
+			}
+			row_index[item] = numrows++;
+			rows.resize(size_t(numrows) * numwords, 0);
+			uint64_t * row = &rows[size_t(row_index[item]) * numwords];
+			for(int item_: get_diffs(item)){
+				row[item_ / 64] |= uint64_t(1) << (item_ % 64);
+			}
+		}
+	}
 public:
+	/* the neighbours of an item, a contiguous range of the adjacency */
+	struct neighbors{
+		const int * first;
+		const int * last;
+		const int * begin() const { return first; }
+		const int * end() const { return last; }
+		int size() const { return int(last - first); }
+	};
+
 	explicit conflict_graph(
 		int numitems_, /** number of items */
 		const vector<pair<int,int>>& items_diff /** items in same constraints */
-	): numitems(numitems_){
-		conflict_list = vector<list<int>> (numitems_, list<int>());
+	): numitems(numitems_), offsets(numitems_ + 1, 0){
 		for(auto p: items_diff){
-			conflict_list[p.first].push_back(p.second);
-			conflict_list[p.second].push_back(p.first);
+			offsets[p.first + 1]++;
+			offsets[p.second + 1]++;
 		}
+		for(int item = 0; item < numitems; item++){
+			offsets[item + 1] += offsets[item];
+		}
+		adjacency.resize(offsets[numitems]);
+		vector<int> next(offsets.begin(), offsets.end() - 1);
+		for(auto p: items_diff){
+			adjacency[next[p.first]++] = p.second;
+			adjacency[next[p.second]++] = p.first;
+		}
+		build_rows();
+	}
+
+	/* the conflict graph relabeled by the positions pos of the items, items[p] is the item at the position p */
+	explicit conflict_graph(
+		const conflict_graph & conflict, /** the conflict graph */
+		const vector<int> & items, /** items at the positions */
+		const vector<int> & pos /** positions of the items */
+	): numitems(conflict.numitems), offsets(conflict.numitems + 1, 0), adjacency(conflict.adjacency.size()){
+		for(int p = 0; p < numitems; p++){
+			auto diffs = conflict.get_diffs(items[p]);
+			offsets[p + 1] = offsets[p] + diffs.size();
+			int k = offsets[p];
+			for(int item_: diffs){
+				adjacency[k++] = pos[item_];
+			}
+		}
+		build_rows();
 	}
+
    explicit  conflict_graph(
 	){
 
    };
-	const list<int> & get_diffs(int item) const{
-		return conflict_list[item];
+
+	neighbors get_diffs(int item) const{
+		return neighbors{adjacency.data() + offsets[item], adjacency.data() + offsets[item + 1]};
+	}
+
+	/* the number of conflicts */
+	int num_diffs() const{
+		return int(adjacency.size()) / 2;
+	}
+
+	/* clear the neighbours of the item in a bitset over the items */
+	void clear_diffs(int item, vector<uint64_t> & bitset) const{
+		if(row_index[item] != -1){
+			const uint64_t * row = &rows[size_t(row_index[item]) * numwords];
+			for(int w = 0; w < numwords; w++){
+				bitset[w] &= ~row[w];
+			}
+		}
+		else{
+			for(int item_: get_diffs(item)){
+				bitset[item_ / 64] &= ~(uint64_t(1) << (item_ % 64));
+			}
+		}
+	}
+};
+
+/* dominance index of items in (mu, b), queried with the objective coefficients of each pricing round.
+ * An item is dominated if a later item has mu <= , b <= and obj >= .
+ * The (mu, b) order and the b ranks only depend on the merged items, so the index is rebuilt only when they change.
+ * A query divides the items into blocks of 2 * half consecutive items for half = 1, 2, 4, ..., and in each block,
+ * the items of the later half are swept over the mu order with a max Fenwick tree over the b ranks against the items of the earlier half,
+ * so every pair of an item and a later item is compared in one block.
+*/
+class dominance_index{
+	int numitems = 0;
+	vector<int> mu_order; // items sorted by increasing mu, increasing b and decreasing item
+	vector<int> b_rank; // 1-based rank of b of items
+public:
+	explicit dominance_index(
+		const vector<SCIP_Real> & mus, /** mus of items */
+		const vector<SCIP_Real> & bs, /** bs of items */
+		int numitems_ /** number of items */
+	): numitems(numitems_), mu_order(numitems_), b_rank(numitems_){
+		for(int item = 0; item < numitems; item++){
+			mu_order[item] = item;
+		}
+		sort(mu_order.begin(), mu_order.end(), [&](int item1, int item2){
+			if(mus[item1] != mus[item2]) return mus[item1] < mus[item2];
+			if(bs[item1] != bs[item2]) return bs[item1] < bs[item2];
+			return item1 > item2; // the later identical items are swept first
+		});
+		vector<int> b_order(mu_order);
+		stable_sort(b_order.begin(), b_order.end(), [&](int item1, int item2){ return bs[item1] < bs[item2]; });
+		int rank = 0;
+		for(int i = 0; i < numitems; i++){
+			if(i == 0 || bs[b_order[i]] != bs[b_order[i - 1]]){
+				rank++;
+			}
+			b_rank[b_order[i]] = rank;
+		}
+	}
+
+	explicit dominance_index(){
+	};
+
+	/* mark the dominated items under the objective coefficients objs */
+	void query(
+		const vector<SCIP_Real> & objs, /** objective coefficients of items */
+		vector<bool> & dominated /** dominated items */
+	) const{
+		dominated.assign(numitems, false);
+		vector<SCIP_Real> fenwick(numitems + 1, -numeric_limits<SCIP_Real>::infinity()); // prefix max of obj over b ranks
+		vector<int> order(numitems);
+		vector<int> block_end;
+		for(int half = 1; half < numitems; half *= 2){
+			int width = 2 * half;
+			int num_blocks = (numitems + width - 1) / width;
+			// stable counting sort of the mu order by the blocks
+			block_end.assign(num_blocks + 1, 0);
+			for(int item: mu_order){
+				block_end[item / width + 1]++;
+			}
+			for(int block = 0; block < num_blocks; block++){
+				block_end[block + 1] += block_end[block];
+			}
+			for(int item: mu_order){
+				order[block_end[item / width]++] = item;
+			}
+			for(int block = 0, first = 0; block < num_blocks; first = block_end[block], block++){
+				for(int i = first; i < block_end[block]; i++){
+					int item = order[i];
+					if(item % width >= half){
+						for(int r = b_rank[item]; r <= numitems; r += r & (-r)){
+							fenwick[r] = max(fenwick[r], objs[item]);
+						}
+					}
+					else if(!dominated[item]){
+						SCIP_Real max_obj = -numeric_limits<SCIP_Real>::infinity();
+						for(int r = b_rank[item]; r > 0; r -= r & (-r)){
+							max_obj = max(max_obj, fenwick[r]);
+						}
+						dominated[item] = max_obj >= objs[item];
+					}
+				}
+				for(int i = first; i < block_end[block]; i++){ // clear the tree for the next block
+					int item = order[i];
+					if(item % width >= half){
+						for(int r = b_rank[item]; r <= numitems && fenwick[r] > -numeric_limits<SCIP_Real>::infinity(); r += r & (-r)){
+							fenwick[r] = -numeric_limits<SCIP_Real>::infinity();
+						}
+					}
+				}
+			}
+		}
 	}
 };
 